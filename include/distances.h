@@ -0,0 +1,331 @@
+#ifndef DISTANCES_H
+#define DISTANCES_H
+
+#include "tsp.h"
+
+#include <math.h>
+
+// Instruction set of the vectorized distance kernels, selected at build time (see TSP_SIMD in CMakeLists.txt)
+// NOTE: SSE2 is always available on x64, AVX2 requires /arch:AVX2 (MSVC) or -mavx2 (GCC)
+#if !defined(TSP_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_AVX2
+#define SIMD_NAME "AVX2"
+#elif !defined(TSP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define SIMD_SSE2
+#define SIMD_NAME "SSE2"
+#else
+#define SIMD_NAME "scalar"
+#endif
+
+// Constants of TSPLIB geographical distance
+#define GEO_PI 3.141592
+#define GEO_EARTH_RADIUS 6378.388
+
+// Distance kernels: one for each edge weight type.
+// They are defined here as static inline functions so that every loop specialized on a kernel 
+// can inline it, without any dispatch inside the loop.
+
+/**
+ * Compute the Euclidean distance between two points.
+ * 
+ * @param x1 The x coordinate of the first point (input)
+ * @param y1 The y coordinate of the first point (input)
+ * @param x2 The x coordinate of the second point (input)
+ * @param y2 The y coordinate of the second point (input)
+ * 
+ * @return The distance between the points
+ */
+static inline double dist(const double x1, const double y1, const double x2, const double y2) {
+
+    double deltax = x1 - x2;
+    double deltay = y1 - y2;
+
+    return sqrt(deltax * deltax + deltay * deltay);
+
+}
+
+/**
+ * Compute the TSPLIB EUC_2D distance: the Euclidean distance rounded to the nearest integer.
+ * 
+ * @param x1 The x coordinate of the first point (input)
+ * @param y1 The y coordinate of the first point (input)
+ * @param x2 The x coordinate of the second point (input)
+ * @param y2 The y coordinate of the second point (input)
+ * 
+ * @return The distance between the points
+ */
+static inline double euc_2d_dist(const double x1, const double y1, const double x2, const double y2) {
+
+    return (double) (int) (dist(x1, y1, x2, y2) + 0.5);
+
+}
+
+/**
+ * Compute the TSPLIB CEIL_2D distance: the Euclidean distance rounded up to the next integer.
+ * 
+ * @param x1 The x coordinate of the first point (input)
+ * @param y1 The y coordinate of the first point (input)
+ * @param x2 The x coordinate of the second point (input)
+ * @param y2 The y coordinate of the second point (input)
+ * 
+ * @return The distance between the points
+ */
+static inline double ceil_2d_dist(const double x1, const double y1, const double x2, const double y2) {
+
+    return ceil(dist(x1, y1, x2, y2));
+
+}
+
+/**
+ * Compute the TSPLIB ATT (pseudo-Euclidean) distance.
+ * 
+ * @param x1 The x coordinate of the first point (input)
+ * @param y1 The y coordinate of the first point (input)
+ * @param x2 The x coordinate of the second point (input)
+ * @param y2 The y coordinate of the second point (input)
+ * 
+ * @return The distance between the points
+ */
+static inline double att_dist(const double x1, const double y1, const double x2, const double y2) {
+
+    double deltax = x1 - x2;
+    double deltay = y1 - y2;
+
+    double rij = sqrt((deltax * deltax + deltay * deltay) / 10.0);
+    double tij = (double) (int) (rij + 0.5);
+
+    return (tij < rij) ? tij + 1.0 : tij;
+
+}
+
+/**
+ * Convert a TSPLIB GEO coordinate (DDD.MM format) in radians.
+ * 
+ * @param value The coordinate in degrees and minutes (input)
+ * 
+ * @return The coordinate in radians
+ */
+static inline double geo_to_radians(const double value) {
+
+    int deg = (int) value;
+    double min = value - deg;
+
+    return GEO_PI * (deg + 5.0 * min / 3.0) / 180.0;
+
+}
+
+/**
+ * Compute the TSPLIB GEO distance: the distance in km on the idealized sphere.
+ * NOTE: x is the latitude and y is the longitude.
+ * 
+ * @param x1 The x coordinate of the first point (input)
+ * @param y1 The y coordinate of the first point (input)
+ * @param x2 The x coordinate of the second point (input)
+ * @param y2 The y coordinate of the second point (input)
+ * 
+ * @return The distance between the points
+ */
+static inline double geo_dist(const double x1, const double y1, const double x2, const double y2) {
+
+    double latitude1 = geo_to_radians(x1);
+    double longitude1 = geo_to_radians(y1);
+    double latitude2 = geo_to_radians(x2);
+    double longitude2 = geo_to_radians(y2);
+
+    double q1 = cos(longitude1 - longitude2);
+    double q2 = cos(latitude1 - latitude2);
+    double q3 = cos(latitude1 + latitude2);
+
+    return (double) (int) (GEO_EARTH_RADIUS * acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+
+}
+
+/**
+ * Convert a distance to the type used to store the costs.
+ * NOTE: Integer costs are rounded to the nearest integer, which is exact for all the TSPLIB integer types.
+ * 
+ * @param value The distance to convert (input)
+ * 
+ * @return The distance as stored cost
+ */
+static inline cost_t to_cost(const double value) {
+
+#if defined(COST_TYPE_INT32)
+    return (cost_t) (value + 0.5);
+#else
+    return (cost_t) value;
+#endif
+
+}
+
+// Vector operations on doubles, written once for both instruction sets
+#if defined(SIMD_AVX2)
+
+typedef __m256d vdouble;
+#define VWIDTH 4
+#define vset1(a) _mm256_set1_pd(a)
+#define vloadu(p) _mm256_loadu_pd(p)
+#define vadd(a, b) _mm256_add_pd(a, b)
+#define vsub(a, b) _mm256_sub_pd(a, b)
+#define vmul(a, b) _mm256_mul_pd(a, b)
+#define vdiv(a, b) _mm256_div_pd(a, b)
+#define vsqrt(a) _mm256_sqrt_pd(a)
+#define vand(a, b) _mm256_and_pd(a, b)
+#define vmin(a, b) _mm256_min_pd(a, b)
+#define vstoreu(p, a) _mm256_storeu_pd(p, a)
+#define vlt(a, b) _mm256_cmp_pd(a, b, _CMP_LT_OQ)
+#define vtrunc(a) _mm256_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)
+
+#elif defined(SIMD_SSE2)
+
+typedef __m128d vdouble;
+#define VWIDTH 2
+#define vset1(a) _mm_set1_pd(a)
+#define vloadu(p) _mm_loadu_pd(p)
+#define vadd(a, b) _mm_add_pd(a, b)
+#define vsub(a, b) _mm_sub_pd(a, b)
+#define vmul(a, b) _mm_mul_pd(a, b)
+#define vdiv(a, b) _mm_div_pd(a, b)
+#define vsqrt(a) _mm_sqrt_pd(a)
+#define vand(a, b) _mm_and_pd(a, b)
+#define vmin(a, b) _mm_min_pd(a, b)
+#define vstoreu(p, a) _mm_storeu_pd(p, a)
+#define vlt(a, b) _mm_cmplt_pd(a, b)
+#define vtrunc(a) _mm_cvtepi32_pd(_mm_cvttpd_epi32(a))     // SSE2 has no rounding: distances always fit an int
+
+#endif
+
+#if defined(SIMD_AVX2) || defined(SIMD_SSE2)
+
+/**
+ * Compute the Euclidean distances between a point and a vector of points.
+ * 
+ * @param x The x coordinate of the point, in every lane (input)
+ * @param y The y coordinate of the point, in every lane (input)
+ * @param xs The x coordinates of the points (input)
+ * @param ys The y coordinates of the points (input)
+ * 
+ * @return The distances, one for each lane
+ */
+static inline vdouble vdist(const vdouble x, const vdouble y, const vdouble xs, const vdouble ys) {
+
+    vdouble deltax = vsub(x, xs);
+    vdouble deltay = vsub(y, ys);
+
+    return vsqrt(vadd(vmul(deltax, deltax), vmul(deltay, deltay)));
+
+}
+
+/**
+ * Compute the TSPLIB EUC_2D distances between a point and a vector of points.
+ * 
+ * @param x The x coordinate of the point, in every lane (input)
+ * @param y The y coordinate of the point, in every lane (input)
+ * @param xs The x coordinates of the points (input)
+ * @param ys The y coordinates of the points (input)
+ * 
+ * @return The distances, one for each lane
+ */
+static inline vdouble veuc_2d_dist(const vdouble x, const vdouble y, const vdouble xs, const vdouble ys) {
+
+    return vtrunc(vadd(vdist(x, y, xs, ys), vset1(0.5)));
+
+}
+
+/**
+ * Compute the TSPLIB CEIL_2D distances between a point and a vector of points.
+ * NOTE: Distances are not negative: the ceiling is the truncation, plus one if something was truncated.
+ * 
+ * @param x The x coordinate of the point, in every lane (input)
+ * @param y The y coordinate of the point, in every lane (input)
+ * @param xs The x coordinates of the points (input)
+ * @param ys The y coordinates of the points (input)
+ * 
+ * @return The distances, one for each lane
+ */
+static inline vdouble vceil_2d_dist(const vdouble x, const vdouble y, const vdouble xs, const vdouble ys) {
+
+    vdouble d = vdist(x, y, xs, ys);
+    vdouble t = vtrunc(d);
+
+    return vadd(t, vand(vlt(t, d), vset1(1.0)));
+
+}
+
+/**
+ * Compute the TSPLIB ATT distances between a point and a vector of points.
+ * 
+ * @param x The x coordinate of the point, in every lane (input)
+ * @param y The y coordinate of the point, in every lane (input)
+ * @param xs The x coordinates of the points (input)
+ * @param ys The y coordinates of the points (input)
+ * 
+ * @return The distances, one for each lane
+ */
+static inline vdouble vatt_dist(const vdouble x, const vdouble y, const vdouble xs, const vdouble ys) {
+
+    vdouble deltax = vsub(x, xs);
+    vdouble deltay = vsub(y, ys);
+
+    vdouble rij = vsqrt(vdiv(vadd(vmul(deltax, deltax), vmul(deltay, deltay)), vset1(10.0)));
+    vdouble tij = vtrunc(vadd(rij, vset1(0.5)));
+
+    return vadd(tij, vand(vlt(tij, rij), vset1(1.0)));
+
+}
+
+/**
+ * Store a vector of distances as costs, converted as to_cost() does.
+ * 
+ * @param out Where to store the costs, VWIDTH of them (output)
+ * @param value The distances to store (input)
+ */
+static inline void vstore_costs(cost_t *out, const vdouble value) {
+
+#if defined(SIMD_AVX2) && defined(COST_TYPE_INT32)
+    _mm_storeu_si128((__m128i *) out, _mm256_cvttpd_epi32(vadd(value, vset1(0.5))));
+#elif defined(SIMD_AVX2) && defined(COST_TYPE_FLOAT)
+    _mm_storeu_ps(out, _mm256_cvtpd_ps(value));
+#elif defined(SIMD_AVX2)
+    _mm256_storeu_pd(out, value);
+#elif defined(COST_TYPE_INT32)
+    _mm_storel_epi64((__m128i *) out, _mm_cvttpd_epi32(vadd(value, vset1(0.5))));
+#elif defined(COST_TYPE_FLOAT)
+    _mm_storel_pi((__m64 *) out, _mm_cvtpd_ps(value));
+#else
+    _mm_storeu_pd(out, value);
+#endif
+
+}
+
+#endif
+
+/**
+ * Return the distance kernel of an edge weight type, so that it is selected once and not for each cost.
+ * 
+ * @param type The edge weight type (input)
+ * 
+ * @return The kernel, the Euclidean one for EUCLIDEAN and for the types without coordinates
+ */
+distance_fn distance_kernel(const EdgeWeightType type);
+
+/**
+ * Compute the distances from a point to a block of points, as they would be stored in the cost matrix.
+ * NOTE: The points are given as structure of arrays, so the kernel reads them with contiguous (vector) loads.
+ * NOTE: The kernel is selected once from the edge weight type of the instance, not for each point.
+ * NOTE: With SIMD_AVX2 or SIMD_SSE2 the distances are computed 4 or 2 at a time (GEO is always scalar),
+ *       with the same rounding of the scalar kernels.
+ * 
+ * @param inst The instance that defines the edge weight type (input)
+ * @param x The x coordinate of the point (input)
+ * @param y The y coordinate of the point (input)
+ * @param xs The x coordinates of the block of points (input)
+ * @param ys The y coordinates of the block of points (input)
+ * @param count The number of points in the block (input)
+ * @param out The distances from the point to each point of the block (output)
+ */
+void distance_row(const instance *inst, const double x, const double y, const double *xs, const double *ys, const int count, cost_t *out);
+
+#endif //DISTANCES_H
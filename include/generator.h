@@ -0,0 +1,136 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include "tsp.h"
+#include "utilities.h"
+#include "utilities_instance.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdbool.h>
+#include <windows.h>
+
+// Synthetic instances for the scaling experiments, in the style of the DIMACS TSP Challenge generators:
+// integer coordinates in a square of side GEN_SIDE and EUC_2D costs, so that the instance written as a TSPLIB file is the same.
+// Each random number depends only on the seed, the node and the draw (counter-based generator):
+// the nodes are generated in parallel and the instance does not depend on the number of threads.
+#define GEN_SIDE 1000000.0              // Side of the square of the coordinates
+#define GEN_CLUSTER_NODES 10            // Average number of nodes of a cluster (DIMACS: n/10 centers)
+#define GEN_GRID_PERTURBATION 0.5       // Maximum shift of a grid node in each direction, as a fraction of the grid step
+#define GEN_DRAWS 4                     // Random numbers reserved for each node
+#define GEN_TWO_PI 6.283185307179586    // 2*pi, for the Gaussian shifts of the clusters
+#define GEN_STREAM_NODES 1              // Stream of the random numbers of the nodes
+#define GEN_STREAM_CENTERS 2            // Stream of the random numbers of the cluster centers
+
+// SplitMix64 constants
+#define SPLITMIX64_GAMMA 0x9E3779B97F4A7C15ULL
+#define SPLITMIX64_MUL1 0xBF58476D1CE4E5B9ULL
+#define SPLITMIX64_MUL2 0x94D049BB133111EBULL
+
+// Structure to hold the data of a thread generating the nodes
+typedef struct {
+
+    instance *inst;         // The instance whose nodes are generated
+    int first;              // First node of the thread
+    int last;               // Last node of the thread, excluded
+
+} generator_worker_data;
+
+/**
+ * Generate a random instance of the family asked (inst->generator, not GEN_RAND) with inst->nnodes nodes.
+ * NOTE: This function allocates the memory for the instance.
+ *
+ * @param inst The instance to fill with the data (input/output)
+ */
+void generate_instance(instance *inst);
+
+/**
+ * Generate the nodes in [first, last) of the instance.
+ * NOTE: Threads write disjoint parts of the coordinates, so they need no synchronization.
+ *
+ * @param param The data of the thread, a generator_worker_data (input/output)
+ *
+ * @return Always 0
+ */
+DWORD WINAPI generator_worker(LPVOID param);
+
+/**
+ * Return the name of a family of random instances.
+ *
+ * @param family The family (input)
+ *
+ * @return The name of the family, as given with -gen
+ */
+const char *generator_family_name(const GeneratorFamily family);
+
+/**
+ * Read the name of a family of random instances.
+ *
+ * @param name The name, as given with -gen (input)
+ * @param family The family (output)
+ *
+ * @return True if the name is a family, false otherwise
+ */
+bool parse_generator_family(const char *name, GeneratorFamily *family);
+
+/**
+ * Finalizer of SplitMix64: scramble the bits of a 64 bit value.
+ *
+ * @param z The value (input)
+ *
+ * @return The scrambled value
+ */
+static inline unsigned long long splitmix64_mix(unsigned long long z) {
+
+    z = (z ^ (z >> 30)) * SPLITMIX64_MUL1;
+    z = (z ^ (z >> 27)) * SPLITMIX64_MUL2;
+
+    return z ^ (z >> 31);
+
+}
+
+/**
+ * Return the counter-th number of the SplitMix64 sequence started from a key, without walking the sequence.
+ *
+ * @param key The key of the sequence (input)
+ * @param counter The position in the sequence (input)
+ *
+ * @return A uniform 64 bit random number
+ */
+static inline unsigned long long counter_random(const unsigned long long key, const unsigned long long counter) {
+
+    return splitmix64_mix(key + (counter + 1) * SPLITMIX64_GAMMA);
+
+}
+
+/**
+ * Return the counter-th number of the sequence of a key as a uniform double in [0, 1), with 53 random bits.
+ *
+ * @param key The key of the sequence (input)
+ * @param counter The position in the sequence (input)
+ *
+ * @return A uniform random number in [0, 1)
+ */
+static inline double counter_random01(const unsigned long long key, const unsigned long long counter) {
+
+    return (double) (counter_random(key, counter) >> 11) * (1.0 / 9007199254740992.0);
+
+}
+
+/**
+ * Return the key of a stream of random numbers of a seed.
+ *
+ * @param seed The seed (input)
+ * @param stream The stream (input)
+ *
+ * @return The key of the stream
+ */
+static inline unsigned long long stream_key(const int seed, const unsigned long long stream) {
+
+    return counter_random((unsigned long long) (unsigned int) seed, stream);
+
+}
+
+#endif //GENERATOR_H
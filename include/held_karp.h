@@ -0,0 +1,78 @@
+#ifndef HELD_KARP_H
+#define HELD_KARP_H
+
+#include "tsp.h"
+#include "utilities.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define HELD_KARP "DP"
+
+// Largest window of the DP re-optimization (-dpwin): 2^(w-2) * (w-2) states
+#define DP_MAX_WINDOW 14
+
+// Window of the DP re-optimization when it is in the chain of local searches (-ls dp) without -dpwin
+#define DP_DEFAULT_WINDOW 10
+
+// Largest instance solved exactly by DP instead of CPLEX: 2^(n-1) * (n-1) states, about 80 MB for n = 20
+#define DP_EXACT_MAX_NODES 20
+
+/**
+ * Allocate the tables of the Held-Karp dynamic programming.
+ *
+ * @param hk The tables to allocate (output)
+ * @param max_inner The largest number of inner nodes of a path, at most DP_EXACT_MAX_NODES - 1 (input)
+ */
+void held_karp_init(held_karp *hk, const int max_inner);
+
+/**
+ * Free the tables of the Held-Karp dynamic programming.
+ *
+ * @param hk The tables to free (input/output)
+ */
+void held_karp_free(held_karp *hk);
+
+/**
+ * Find the best Hamiltonian path from start to end through the inner nodes, with the Held-Karp dynamic programming:
+ * the best path through each subset of inner nodes ending at each of them, by increasing subsets (bitmasks).
+ * NOTE: This function assumes m <= hk->max_inner, and start and end different from the inner nodes (start = end for a tour).
+ *
+ * @param hk The tables (input/output)
+ * @param inst The instance that contains the problem data (input)
+ * @param start The first node of the path (input)
+ * @param end The last node of the path (input)
+ * @param inner The nodes between start and end (input)
+ * @param m The number of inner nodes (input)
+ * @param order The inner nodes in the order of the best path (output)
+ *
+ * @return The cost of the best path
+ */
+double held_karp_path(held_karp *hk, const instance *inst, const int start, const int end, const int *inner, const int m, int *order);
+
+/**
+ * Solve the instance exactly with the Held-Karp dynamic programming, without CPLEX.
+ * NOTE: This function assumes nnodes <= DP_EXACT_MAX_NODES.
+ *
+ * @param inst The instance that contains the problem data (input)
+ * @param sol The optimal solution (output)
+ */
+void held_karp_tour(const instance *inst, solution *sol);
+
+/**
+ * Re-optimize the tour by windows: a window of inst->dp_window consecutive nodes slides along the tour
+ * and its inner nodes are put in the order of the best path between its two ends (held_karp_path()).
+ * The sweeps are repeated as long as a window improves.
+ * NOTE: Without a window asked (inst->dp_window = 0) the windows have DP_DEFAULT_WINDOW nodes.
+ * NOTE: Windows of fewer than 4 nodes cannot change the tour, nothing is done.
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the algorithm (input)
+ * @param print True to print the improvement of the incumbent (input)
+ */
+void dp_window(const instance *inst, solution *sol, const double timelimit, bool print);
+
+#endif //HELD_KARP_H
@@ -5,6 +5,7 @@
 #include "utilities.h"
 #include "utilities_instance.h"
 #include "utilities_solution.h"
+#include "local_search.h"
 
 #include <math.h>
 #include <time.h>
@@ -34,6 +35,21 @@
  */
 int find_nearest_node(const instance *inst, const int len, const int *visited_nodes);
 
+/**
+ * Finds the nearest node as find_nearest_node(), but from coordinates stored in the same order of the array of nodes.
+ * NOTE: The distances to the unvisited nodes are computed as one contiguous block, which the distance kernel vectorizes.
+ * NOTE: Used in matrix-free mode, where find_nearest_node() would compute each distance from scattered coordinates.
+ * 
+ * @param inst The instance that contains the problem data (input)
+ * @param len The current length of the explored part of the array (input)
+ * @param xs The x coordinates of the nodes, in the order of the array of nodes (input)
+ * @param ys The y coordinates of the nodes, in the order of the array of nodes (input)
+ * @param buffer Working memory of at least nnodes costs (output)
+ * 
+ * @return The index of nearest node, -1 if there is no nearest node
+ */
+int find_nearest_point(const instance *inst, const int len, const double *xs, const double *ys, cost_t *buffer);
+
 /**
  * Swaps two nodes in the array at the given indices.
  * NOTE: This finction assumes that the indices are within the bounds of the array. 
@@ -55,17 +71,17 @@ void swap_nodes(int *nodes, const int i, const int j);
 void reverse_segment(solution *sol, const int i, const int j);
 
 /**
- * Reorder tour segments in the solution following this pattern:
- * A -> C -> B (reorder from A -> B -> C to A -> C -> B).
- * NOTE: This function assumes 0 <= idx1 < idx2 < idx3 < nnodes.
+ * Apply the 2-opt move (i, j) of delta2(): reverse the segment between i and j, keeping the cached edge costs up to date.
+ * NOTE: The cached costs inside the segment are reversed with it, only the two new edges are computed.
+ * NOTE: The cost of the solution is not updated.
+ * NOTE: This function assumes 1 <= i <= j < nnodes.
  * 
- * @param sol The solution where the nodes are reordered (input/output)
- * @param n The number of nodes in the instance (input)
- * @param idx1 The first index (input)
- * @param idx2 The second index (input)
- * @param idx3 The third index (input)
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to modify (input/output)
+ * @param i The first index (input)
+ * @param j The last index (input)
  */
-void shift_segment(solution *sol, const int n, const int idx1, const int idx2, const int idx3);
+void apply_two_opt_move(const instance *inst, solution *sol, const int i, const int j);
 
 /**
  * Compute the delta cost after the 2-opt move: 
@@ -82,6 +98,56 @@ void shift_segment(solution *sol, const int n, const int idx1, const int idx2, c
  */
 double delta2(const instance *inst, const solution *sol, const int i, const int j);
 
+/**
+ * Allocate the working memory of the 2-opt scan.
+ * 
+ * @param scan The scan to initialize (output)
+ * @param inst The instance that contains the problem to solve (input)
+ */
+void two_opt_scan_init(two_opt_scan *scan, const instance *inst);
+
+/**
+ * Free the working memory of the 2-opt scan.
+ * 
+ * @param scan The scan to free (input/output)
+ */
+void two_opt_scan_free(two_opt_scan *scan);
+
+/**
+ * Load the tour of a solution in the 2-opt scan: coordinates and edge costs in tour order.
+ * NOTE: The tour must be loaded again after each move applied on the solution.
+ * 
+ * @param scan The scan (input/output)
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution that contains the tour (input)
+ */
+void two_opt_scan_load(two_opt_scan *scan, const instance *inst, const solution *sol);
+
+/**
+ * Compute the deltas of the 2-opt moves (i, j) for a fixed i and j from first to last, as delta2() does.
+ * NOTE: This function assumes 1 <= i < first <= last < nnodes.
+ * 
+ * @param scan The scan with the tour loaded (input/output)
+ * @param inst The instance that contains the problem to solve (input)
+ * @param i The first index (input)
+ * @param first The first value of the second index (input)
+ * @param last The last value of the second index (input)
+ * 
+ * @return The deltas, the one of move (i, j) at position j - first (working memory of the scan: the caller may
+ *         overwrite them, e.g. to mask the moves it excludes, until the next row is computed)
+ */
+double *two_opt_scan_row(two_opt_scan *scan, const instance *inst, const int i, const int first, const int last);
+
+/**
+ * Find the minimum of an array of deltas, with a vector min-reduction when SIMD_AVX2 or SIMD_SSE2.
+ * 
+ * @param delta The deltas (input)
+ * @param count The number of deltas (input)
+ * 
+ * @return The minimum delta, INFINITY if count is 0
+ */
+double min_delta(const double *delta, const int count);
+
 /**
  * Compute the delta cost after the 3-opt move: 
  * - remove edges (idx1, idx1+1), (idx2, idx2+1), (idx3, idx3+1)
@@ -96,6 +162,30 @@ double delta2(const instance *inst, const solution *sol, const int i, const int
  */
 double delta3(const instance *inst, const solution *sol, const int idx1, const int idx2, const int idx3);
 
+/**
+ * Apply a k-opt move on the visited nodes of the solution, in place: the segments of the move are copied
+ * in the scratch buffer once, then written back in their new order.
+ * NOTE: The cost of the solution is not updated (see kopt_delta()), the cached edge costs of the region are recomputed.
+ * NOTE: This function assumes 0 <= idx[0] < ... < idx[k-1] < nnodes and order a permutation of 1, ..., k-1.
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to modify (input/output)
+ * @param move The move (input)
+ * @param scratch A buffer of at least nnodes entries, reused between the moves (input/output)
+ */
+void apply_kopt_move(const instance *inst, solution *sol, const kopt_move *move, int *scratch);
+
+/**
+ * Compute the delta cost of a k-opt move: the cost of the k edges added minus the one of the k edges removed.
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution that contains the tour (input)
+ * @param move The move (input)
+ *
+ * @return Cost of the new edges minus cost of the old edges
+ */
+double kopt_delta(const instance *inst, const solution *sol, const kopt_move *move);
+
 //---------------------------------------- heuristics ----------------------------------------
 
 //--- NEAREST NEIGHBOR ---
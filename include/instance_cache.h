@@ -0,0 +1,140 @@
+#ifndef INSTANCE_CACHE_H
+#define INSTANCE_CACHE_H
+
+#include "tsp.h"
+#include "utilities.h"
+#include "utilities_instance.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <windows.h>
+
+// Binary instance cache (.tspbin): the built instance of an input file, written next to it on the first load
+// and memory-mapped read-only on the following ones. It can also be written directly (-out) and passed as input file.
+// Layout: a header, then the sections, each one aligned to CACHE_ALIGNMENT bytes from the beginning of the file.
+#define CACHE_MAGIC "TSPBIN1"
+#define CACHE_EXTENSION "bin"       // Appended to the name of the input file: "u1060.tsp" -> "u1060.tspbin"
+#define CACHE_FILE_SUFFIX ".tspbin" // Suffix of a cache file given as input or output file
+#define CACHE_ALIGNMENT 64
+
+// FNV-1a 64 bit constants, used to hash the content of the input file
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// Structure to hold the header of a cache file
+typedef struct {
+
+    char magic[8];                      // CACHE_MAGIC, also the version of the layout
+    unsigned long long source_hash;     // FNV-1a hash of the content of the input file, 0 if written directly
+    unsigned long long file_size;       // Size of the whole cache file
+    char cost_type[8];                  // COST_TYPE_NAME of the stored costs
+    int cost_size;                      // sizeof(cost_t) of the stored costs
+    int nnodes;                         // Number of nodes
+    int edge_weight_type;               // EdgeWeightType of the instance
+    int cand_k;                         // Length of the candidate lists, 0 if there are none
+    int hilbert;                        // 1 if the nodes were renumbered along a Hilbert curve
+    int has_coord;                      // 1 if the coordinates are stored
+    int has_costs;                      // 1 if the cost matrix is stored (not in matrix-free mode)
+    int cost_layout;                    // CostLayout of the stored costs
+    unsigned long long offset_x;        // Offset of the x coordinates (nnodes doubles), 0 if none
+    unsigned long long offset_y;        // Offset of the y coordinates (nnodes doubles), 0 if none
+    unsigned long long offset_costs;    // Offset of the cost matrix (cost_matrix_size() costs), 0 if none
+    unsigned long long offset_cand;     // Offset of the candidate lists (nnodes*cand_k ints), 0 if none
+    unsigned long long offset_cand_cost;// Offset of the candidate costs (nnodes*cand_k costs), 0 if none
+    unsigned long long offset_original_id; // Offset of the original ids (nnodes ints), 0 if not renumbered
+
+} cache_header;
+
+/**
+ * Load the instance from a cache file, if it is valid: same cost type and, if asked, same content of the input file
+ * and same build options (candidate lists, renumbering, matrix-free mode, cost layout).
+ * NOTE: The cost matrix and the candidate lists point inside the read-only mapping (cache_view),
+ *       the coordinates and the original ids are copied.
+ * NOTE: Without the check of the source, the build options stored in the file are used instead of the asked ones.
+ * 
+ * @param inst The instance with the options (input/output)
+ * @param filename The path of the cache file (input)
+ * @param source_hash The hash of the content of the input file (input)
+ * @param check_source True to check the input file and the build options, false for a cache file given as input (input)
+ * 
+ * @return True if the instance was loaded, false if there is no valid cache file
+ */
+bool load_instance_cache(instance *inst, const char *filename, const unsigned long long source_hash, const bool check_source);
+
+/**
+ * Write the cache file of a built instance, replacing the previous one.
+ * NOTE: A cache that cannot be written is not an error: it is reported at verbose LOW and skipped.
+ * 
+ * @param inst The built instance (input)
+ * @param filename The path of the cache file (input)
+ * @param source_hash The hash of the content of the input file, 0 if there is none (input)
+ * 
+ * @return True if the file was written, false otherwise
+ */
+bool save_instance_cache(const instance *inst, const char *filename, const unsigned long long source_hash);
+
+/**
+ * Release the mapping of the cache file, if the instance was loaded from it.
+ * NOTE: The arrays pointing inside the mapping (costs and candidate lists) must not be used after this.
+ * 
+ * @param inst The instance (input/output)
+ */
+void close_instance_cache(instance *inst);
+
+/**
+ * Hash the content of a file with FNV-1a, through a read-only memory mapping.
+ * 
+ * @param filename The path of the file (input)
+ * @param hash The hash of the content (output)
+ * 
+ * @return True if the file was read, false otherwise
+ */
+bool hash_file(const char *filename, unsigned long long *hash);
+
+/**
+ * Build the path of the cache file of the input file of an instance.
+ * 
+ * @param inst The instance with the input file (input)
+ * @param filename The path of the cache file, FILE_NAME_LEN characters (output)
+ * 
+ * @return True if the path fits in FILE_NAME_LEN characters, false otherwise (the cache is not used)
+ */
+bool cache_file_name(const instance *inst, char *filename);
+
+/**
+ * Check if a path names a cache file, from its suffix.
+ * 
+ * @param filename The path (input)
+ * 
+ * @return True if the path ends with CACHE_FILE_SUFFIX, false otherwise
+ */
+bool is_cache_file(const char *filename);
+
+/**
+ * Round an offset up to the next multiple of CACHE_ALIGNMENT.
+ * 
+ * @param offset The offset (input)
+ * 
+ * @return The aligned offset
+ */
+static inline unsigned long long cache_align(const unsigned long long offset) {
+
+    return (offset + CACHE_ALIGNMENT - 1) / CACHE_ALIGNMENT * CACHE_ALIGNMENT;
+
+}
+
+/**
+ * Write a section of the cache file at its offset, padding with zeros from the current position.
+ * 
+ * @param f The cache file (input/output)
+ * @param offset The offset of the section (input)
+ * @param data The content of the section (input)
+ * @param size The size of the section in bytes (input)
+ * 
+ * @return True if the section was written, false otherwise
+ */
+bool write_cache_section(FILE *f, const unsigned long long offset, const void *data, const size_t size);
+
+#endif //INSTANCE_CACHE_H
@@ -0,0 +1,234 @@
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include "tsp.h"
+#include "utilities.h"
+#include "distances.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+// Maximum number of points in a leaf of the kd-tree
+#define KD_BUCKET 16
+
+// Structure to hold a node of the kd-tree: a box of the plane and the points inside it
+typedef struct {
+
+    int begin;              // First point of the node, as index in perm
+    int end;                // One past the last point of the node, as index in perm
+    int left;               // Index of the left child (coordinate <= split), -1 for a leaf
+    int right;              // Index of the right child (coordinate >= split), -1 for a leaf
+    int parent;             // Index of the parent, -1 for the root
+    int alive;              // Number of points of the node not deleted
+    int dim;                // Splitting dimension: 0 for x, 1 for y
+    double split;           // Splitting value
+    double xmin;            // Bounding box of the points of the node
+    double xmax;
+    double ymin;
+    double ymax;
+
+} kd_node;
+
+// Structure to hold a 2D kd-tree over a set of points
+typedef struct {
+
+    const double *x;        // x coordinate of the points (not owned by the tree)
+    const double *y;        // y coordinate of the points (not owned by the tree)
+    int npoints;            // Number of points
+    int *perm;              // Points reordered so that the points of each node are contiguous
+    double *px;             // x coordinate of the points in the order of perm, for contiguous scans of the leaves
+    double *py;             // y coordinate of the points in the order of perm
+    kd_node *nodes;         // Nodes of the tree, the root is nodes[0]
+    int nnodes;             // Number of nodes of the tree
+    int *leaf;              // Leaf of each point
+    bool *deleted;          // Soft deletion flag of each point
+
+} kd_tree;
+
+/**
+ * Build a kd-tree over a set of points in O(n log n) expected time.
+ * NOTE: Each node is split at the median of its widest dimension, until it has at most KD_BUCKET points.
+ * NOTE: The coordinates are not copied: they must live as long as the tree.
+ * 
+ * @param tree The tree to build (output)
+ * @param x The x coordinate of the points (input)
+ * @param y The y coordinate of the points (input)
+ * @param npoints The number of points (input)
+ */
+void build_kd_tree(kd_tree *tree, const double *x, const double *y, const int npoints);
+
+/**
+ * Check if the costs of an instance can be searched with a kd-tree: they must be a non-decreasing function
+ * of the Euclidean distance between the coordinates.
+ * NOTE: GEO costs are distances on the sphere and EXPLICIT instances may have no coordinates at all.
+ * 
+ * @param inst The instance to check (input)
+ * 
+ * @return True if the kd-tree can be used, false otherwise
+ */
+static inline bool kd_tree_supports(const instance *inst) {
+
+    return inst->x != NULL && inst->edge_weight_type != GEO && inst->edge_weight_type != EXPLICIT;
+
+}
+
+/**
+ * Free the memory of a kd-tree.
+ * 
+ * @param tree The tree to free (input/output)
+ */
+void free_kd_tree(kd_tree *tree);
+
+/**
+ * Build recursively the subtree over the points perm[begin..end).
+ * 
+ * @param tree The tree to build (input/output)
+ * @param begin The first point of the subtree, as index in perm (input)
+ * @param end One past the last point of the subtree, as index in perm (input)
+ * @param parent The index of the parent of the subtree, -1 for the root (input)
+ * 
+ * @return The index of the root of the subtree
+ */
+int build_kd_node(kd_tree *tree, const int begin, const int end, const int parent);
+
+/**
+ * Reorder perm[begin..end) so that the point at index k has the k-th smallest coordinate in the given dimension,
+ * the points before it are not greater and the points after it are not smaller (quickselect).
+ * 
+ * @param tree The tree with the points (input/output)
+ * @param begin The first index of the range (input)
+ * @param end One past the last index of the range (input)
+ * @param k The index to select (input)
+ * @param dim The dimension to compare: 0 for x, 1 for y (input)
+ */
+void kd_select(kd_tree *tree, int begin, int end, const int k, const int dim);
+
+/**
+ * Find the k points nearest (in Euclidean distance) to a point of the tree, the point itself excluded.
+ * NOTE: Points at the same distance are ordered by increasing index.
+ * 
+ * @param tree The tree with the points (input)
+ * @param point The index of the query point (input)
+ * @param k The number of points to find (input)
+ * @param nearest The indices of the nearest points, by increasing distance, at least k of them (output)
+ * @param dist2 The squared distances of the nearest points, at least k of them (output)
+ * 
+ * @return The number of points found: k, or npoints-1 if there are not enough points
+ */
+int kd_tree_k_nearest(const kd_tree *tree, const int point, const int k, int *nearest, double *dist2);
+
+/**
+ * Visit recursively a subtree for kd_tree_k_nearest(), skipping the subtrees farther than the current k-th point.
+ * 
+ * @param tree The tree with the points (input)
+ * @param node The index of the root of the subtree (input)
+ * @param point The index of the query point (input)
+ * @param k The number of points to find (input)
+ * @param nearest The nearest points found so far, by increasing distance (input/output)
+ * @param dist2 The squared distances of the nearest points found so far (input/output)
+ * @param found The number of points found so far (input/output)
+ */
+void kd_search_k_nearest(const kd_tree *tree, const int node, const int point, const int k, int *nearest, double *dist2, int *found);
+
+/**
+ * Delete a point from the tree: it is skipped by the following queries (soft deletion).
+ * NOTE: The alive counters of the nodes from its leaf to the root are decreased, so empty subtrees are pruned.
+ * 
+ * @param tree The tree with the points (input/output)
+ * @param point The index of the point to delete (input)
+ */
+void kd_tree_delete(kd_tree *tree, const int point);
+
+/**
+ * Find the point not deleted with the minimum cost from a point, w.r.t. the costs of the instance.
+ * NOTE: The instance must be supported, see kd_tree_supports().
+ * NOTE: Points with the same cost are broken by the minimum rank, as a linear scan in the order of rank would do.
+ * 
+ * @param tree The tree over the coordinates of the instance (input)
+ * @param point The index of the query point (input)
+ * @param rank The rank of each point for breaking ties, NULL to break them by index (input)
+ * @param inst The instance with the costs (input)
+ * @param nearest_cost The cost from the point to the nearest point, INFINITY if there is none (output)
+ * 
+ * @return The index of the nearest point, -1 if all the points are deleted
+ */
+int kd_tree_nearest_alive(const kd_tree *tree, const int point, const int *rank, const instance *inst, double *nearest_cost);
+
+/**
+ * Visit recursively a subtree for kd_tree_nearest_alive(), skipping the empty subtrees and those whose bounding box
+ * costs more than the best point found so far.
+ * 
+ * @param tree The tree over the coordinates of the instance (input)
+ * @param node The index of the root of the subtree (input)
+ * @param point The index of the query point (input)
+ * @param rank The rank of each point for breaking ties, NULL to break them by index (input)
+ * @param inst The instance with the costs (input)
+ * @param best The nearest point found so far, -1 if none (input/output)
+ * @param best_cost The cost of the nearest point found so far (input/output)
+ */
+void kd_search_nearest_alive(const kd_tree *tree, const int node, const int point, const int *rank, const instance *inst, int *best, double *best_cost);
+
+/**
+ * Compute a lower bound on the cost from a point to any point inside the bounding box of a node.
+ * NOTE: The cost to the nearest point of the box, computed with the same kernel: it does not exceed the cost
+ *       to any point of the box, also with floating point rounding.
+ * 
+ * @param node The node of the tree (input)
+ * @param x The x coordinate of the point (input)
+ * @param y The y coordinate of the point (input)
+ * @param inst The instance with the edge weight type (input)
+ * 
+ * @return The lower bound on the cost
+ */
+static inline double kd_box_cost(const kd_node *node, const double x, const double y, const instance *inst) {
+
+    double bx = (x < node->xmin) ? node->xmin : ((x > node->xmax) ? node->xmax : x);
+    double by = (y < node->ymin) ? node->ymin : ((y > node->ymax) ? node->ymax : y);
+
+    switch (inst->edge_weight_type) {
+
+        case EUC_2D:    return (double) to_cost(euc_2d_dist(x, y, bx, by));
+        case CEIL_2D:   return (double) to_cost(ceil_2d_dist(x, y, bx, by));
+        case ATT:       return (double) to_cost(att_dist(x, y, bx, by));
+        default:        return (double) to_cost(dist(x, y, bx, by));
+
+    }
+
+}
+
+/**
+ * Compute the cost between the query point and a point of a leaf, as cost() does.
+ * NOTE: Without cost matrix the kernel reads the coordinates of the tree, contiguous along the leaf,
+ *       instead of those of the instance: the arguments are the same, so is the cost.
+ * 
+ * @param tree The tree over the coordinates of the instance (input)
+ * @param i The index in perm of the point of the leaf (input)
+ * @param x The x coordinate of the query point (input)
+ * @param y The y coordinate of the query point (input)
+ * @param point The index of the query point (input)
+ * @param p The index of the point of the leaf, perm[i] (input)
+ * @param inst The instance with the costs (input)
+ * 
+ * @return The cost between the two points
+ */
+double kd_point_cost(const kd_tree *tree, const int i, const double x, const double y, const int point, const int p, const instance *inst);
+
+/**
+ * Compute the squared distance between a point and the bounding box of a node, 0 if the point is inside.
+ * 
+ * @param node The node of the tree (input)
+ * @param x The x coordinate of the point (input)
+ * @param y The y coordinate of the point (input)
+ * 
+ * @return The squared distance
+ */
+static inline double kd_box_dist2(const kd_node *node, const double x, const double y) {
+
+    double dx = (x < node->xmin) ? node->xmin - x : ((x > node->xmax) ? x - node->xmax : 0.0);
+    double dy = (y < node->ymin) ? node->ymin - y : ((y > node->ymax) ? y - node->ymax : 0.0);
+
+    return dx * dx + dy * dy;
+
+}
+
+#endif //KD_TREE_H
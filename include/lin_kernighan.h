@@ -0,0 +1,99 @@
+#ifndef LIN_KERNIGHAN_H
+#define LIN_KERNIGHAN_H
+
+#include "tsp.h"
+#include "tour.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define LIN_KERNIGHAN "LK"
+
+// Longest segment moved by a kick of the chained Lin-Kernighan
+#define LK_KICK_SEGMENT 50
+
+// Structure to hold a step of a Lin-Kernighan move: the edges (t1, t2), (t3, t4) are replaced with (t2, t3), (t4, t1)
+typedef struct {
+
+    int t2;                 // Node whose edge to t1 is removed
+    int t3;                 // Candidate of t2, the new edge (t2, t3) is added
+    int t4;                 // Neighbor of t3, the edge (t3, t4) is removed and (t4, t1) closes the tour
+
+} lk_step;
+
+/**
+ * Lin-Kernighan local search over the candidate lists, with don't-look bits.
+ * A move is a sequence of 2-opt moves from the same node t1 (variable depth, up to inst->lk_depth steps):
+ * each step removes the edge (t1, t2) closing the tour and an edge (t3, t4), with t3 a candidate of t2,
+ * as long as the gain of the open path stays positive. The sequence is cut back to its best closed tour.
+ * The first step tries all the candidates of both neighbours of t1, the next ones the best candidate only.
+ * NOTE: Without candidate lists the full 2-opt (two_opt()) is used.
+ * NOTE: The cost of the solution is recomputed at the end, so it is the one of compute_solution_cost().
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the algorithm (input)
+ * @param print True to print the improvement of the incumbent (input)
+ */
+void lin_kernighan(const instance *inst, solution *sol, const double timelimit, bool print);
+
+/**
+ * Chained Lin-Kernighan: Lin-Kernighan from the solution, then kicks until the time limit.
+ * A kick is a double bridge (tour_double_bridge()) on three consecutive random segments of at most LK_KICK_SEGMENT nodes,
+ * and Lin-Kernighan starts again from the eight nodes of the kick only: a worse tour is undone with the log of the tour.
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the algorithm (input)
+ */
+void chained_lin_kernighan(const instance *inst, solution *sol, const double timelimit);
+
+/**
+ * Apply Lin-Kernighan moves from the nodes in the work queue, until it is empty or the time limit is reached.
+ * NOTE: The log of the tour must be started: lk_move() undoes its last steps with it.
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param t The tour (input/output)
+ * @param q The work queue of the nodes to start from (input/output)
+ * @param steps Buffer for the steps of a move, inst->lk_depth entries (input/output)
+ * @param t_start The starting time (input)
+ * @param timelimit The time limit (input)
+ * @param keep_log True to keep the moves in the log, to undo them later (e.g. after a kick), false to empty it after each move (input)
+ * @param moves The number of moves applied, increased (input/output)
+ *
+ * @return The decrease of the cost of the tour
+ */
+double lk_optimize(const instance *inst, tour *t, work_queue *q, lk_step *steps, const double t_start, const double timelimit, const bool keep_log, int *moves);
+
+/**
+ * Build a Lin-Kernighan move from t1, with the first step fixed: t2 is a neighbor of t1 and t3 a candidate of t2.
+ * The steps are applied on the tour, and the ones after the best closed tour are undone.
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param t The tour (input/output)
+ * @param t1 The first node (input)
+ * @param t2 The neighbor of t1 (input)
+ * @param t3 The candidate of t2 (input)
+ * @param steps The steps of the move (output)
+ * @param depth The number of steps kept (output)
+ *
+ * @return The gain of the move, 0 if no step is kept
+ */
+double lk_move(const instance *inst, tour *t, const int t1, const int t2, const int t3, lk_step *steps, int *depth);
+
+/**
+ * Check if an edge is one of the edges added or removed by the steps of a Lin-Kernighan move.
+ *
+ * @param steps The steps (input)
+ * @param depth The number of steps (input)
+ * @param u The first node of the edge (input)
+ * @param v The second node of the edge (input)
+ * @param added True to check the added edges (t2, t3), false for the removed ones (t3, t4) (input)
+ *
+ * @return True if the edge is found, false otherwise
+ */
+bool lk_edge_in_steps(const lk_step *steps, const int depth, const int u, const int v, const bool added);
+
+#endif //LIN_KERNIGHAN_H
@@ -0,0 +1,247 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include "tsp.h"
+#include "utilities.h"
+#include "heuristics.h"
+#include "tour.h"
+#include "lin_kernighan.h"
+#include "held_karp.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <windows.h>
+
+// Names of the local searches, as given with -ls
+#define LS_2OPT_NAME "2opt"
+#define LS_2OPT_NL_NAME "2opt_nl"
+#define LS_OR_OPT_NAME "oropt"
+#define LS_3OPT_NAME "3opt"
+#define LS_LK_NAME "lk"
+#define LS_2OPT_PAR_NAME "2opt_par"
+#define LS_DP_WINDOW_NAME "dp"
+
+// Length of the name of a chain of local searches, as given with -ls
+#define LS_CHAIN_NAME_LEN 128
+
+// Longest segment moved by Or-opt
+#define OR_OPT_MAX_SEGMENT 3
+
+// Parallel 2-opt: shortest sub-path of a thread, and maximum number of rounds before the sequential 2-opt
+#define TWO_OPT_PAR_MIN_CHUNK 1000
+#define TWO_OPT_PAR_MAX_ROUNDS 10
+
+// Structure to hold the data of a thread of the parallel 2-opt: the sub-path of the tour between two fixed positions
+typedef struct {
+
+    const instance *inst;   // The instance that contains the problem to solve
+    int *nodes;             // The visited nodes of the solution, shared by the threads
+    int *pos;               // Position of each node, shared: a thread writes only the positions of its own nodes
+    const int *owner;       // Sub-path of each node, read only during a round
+    bool *queued;           // True if the node is in the work queue of its thread, shared: a thread writes only its own nodes
+    bool *pending;          // True if the node must be examined in the next round, shared as queued
+    int id;                 // Sub-path of the thread
+    int first;              // Position of the first node of the sub-path, which does not move
+    int last;               // Position of the last node of the sub-path, which does not move
+    double t_start;         // Start of the local search
+    double timelimit;       // Time limit of the local search
+    bool or_opt;            // True to apply the Or-opt moves too
+    int moves;              // Number of moves applied by the thread in the round
+
+} two_opt_chunk_data;
+
+// Signature of a local search: refine the solution until its local optimum or the time limit
+typedef void (*local_search_fn)(const instance *inst, solution *sol, const double timelimit, bool print);
+
+// Structure to hold a local search of the registry (see find_local_search())
+typedef struct {
+
+    LocalSearchType type;   // The local search
+    const char *name;       // Its name, as given with -ls
+    local_search_fn run;    // The function that applies it
+    bool needs_candidates;  // True if it uses the candidate lists
+
+} ls_operator;
+
+/**
+ * Refine the solution with the chain of local searches asked (build_local_search_chain()), applied by vnd().
+ * This is the entry point used by the methods wherever a solution is refined.
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the local search (input)
+ * @param print True to print the improvements of the incumbent (input)
+ */
+void local_search(const instance *inst, solution *sol, const double timelimit, bool print);
+
+/**
+ * Build the chain of local searches applied by local_search(): the one asked (inst->local_search), followed by
+ * Or-opt if asked (inst->or_opt) and by the DP windows if asked (inst->dp_window), when they are not already in it.
+ *
+ * @param inst The instance with the local searches asked (input)
+ * @param chain The chain of local searches (output)
+ */
+void build_local_search_chain(const instance *inst, ls_chain *chain);
+
+/**
+ * Variable Neighborhood Descent over a chain of local searches: each one is applied from the local optimum of the
+ * previous ones, and after an improvement the descent starts again from the first one (or goes on to the second
+ * one, if the first one improved). It stops when no local search of the chain improves the solution.
+ * NOTE: A chain of one local search applies it once.
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param chain The local searches, from the cheapest (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the descent (input)
+ * @param print True to print the improvements of the incumbent (input)
+ */
+void vnd(const instance *inst, const ls_chain *chain, solution *sol, const double timelimit, bool print);
+
+/**
+ * 2-opt over the candidate lists, with don't-look bits.
+ * Only the moves that add an edge from a node to one of its candidates are evaluated, and a node is examined
+ * only while it is in the work queue: it is queued again when one of its tour edges changes.
+ * The moves are applied on a tour with the position of each node, reversing the shorter side.
+ * NOTE: Without candidate lists the full 2-opt (two_opt()) is used.
+ * NOTE: The cost of the solution is recomputed at the end, so it is the one of compute_solution_cost().
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the algorithm (input)
+ * @param print True to print the improvement of the incumbent (input)
+ */
+void two_opt_nl(const instance *inst, solution *sol, const double timelimit, bool print);
+
+/**
+ * Or-opt over the candidate lists, with don't-look bits: move a segment of 1 to OR_OPT_MAX_SEGMENT nodes,
+ * possibly reversed, so that one of its ends is next to one of its candidates.
+ * The delta of a move is computed in O(1) from the three removed and the three added edges,
+ * the move is applied as 2-opt moves on the tour, without allocating memory.
+ * NOTE: Without candidate lists nothing is done.
+ * NOTE: The cost of the solution is recomputed at the end, so it is the one of compute_solution_cost().
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the algorithm (input)
+ * @param print True to print the improvement of the incumbent (input)
+ */
+void or_opt(const instance *inst, solution *sol, const double timelimit, bool print);
+
+/**
+ * 3-opt over the candidate lists, with don't-look bits.
+ * The moves are built as sequences t1, ..., t6: the edges (t1, t2), (t3, t4), (t5, t6) are replaced with
+ * (t2, t3), (t4, t5), (t6, t1), where t3 is a candidate of t2 and t5 a candidate of t4.
+ * A sequence is extended only while the partial gain is positive, so the sorted lists are cut as soon as
+ * a new edge is too long. All the reconnections are evaluated: the 2-opt ones when closing at t4,
+ * the four that change all the three edges (Reconnection) when closing at t6.
+ * NOTE: Without candidate lists the full 2-opt (two_opt()) is used.
+ * NOTE: The cost of the solution is recomputed at the end, so it is the one of compute_solution_cost().
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the algorithm (input)
+ * @param print True to print the improvement of the incumbent (input)
+ */
+void three_opt(const instance *inst, solution *sol, const double timelimit, bool print);
+
+/**
+ * Parallel 2-opt over the candidate lists: the tour is split in one sub-path for each thread, with fixed ends,
+ * and each thread applies the 2-opt moves whose two removed edges are in its sub-path (two_opt_chunk_worker()),
+ * and the Or-opt moves whose three removed edges are in it when Or-opt is in the chain (e.g. -ls 2opt_par,oropt).
+ * The rounds are repeated with the boundaries moved (the tour is rotated by a random offset) as long as they improve,
+ * each from the nodes left pending by the previous one,
+ * then the sequential 2-opt over the candidate lists (two_opt_nl()) applies the moves across the sub-paths
+ * (the Or-opt moves across them are left to or_opt(), next in the chain).
+ * NOTE: With one thread, or sub-paths shorter than TWO_OPT_PAR_MIN_CHUNK, only the sequential 2-opt is used.
+ * NOTE: The cost of the solution is recomputed at the end, so it is the one of compute_solution_cost().
+ *
+ * @param inst The instance that contains the problem to solve (input)
+ * @param sol The solution to refine (input/output)
+ * @param timelimit The time limit for the algorithm (input)
+ * @param print True to print the improvement of the incumbent (input)
+ */
+void two_opt_par(const instance *inst, solution *sol, const double timelimit, bool print);
+
+/**
+ * 2-opt over the candidate lists on the sub-path of a thread of two_opt_par(), with don't-look bits.
+ * If asked (data->or_opt), the Or-opt moves of the segments with an end at the node are evaluated too, as in or_opt(),
+ * and the best move of the two neighbourhoods is applied (the segment is moved with reversals).
+ * Only the candidates in the sub-path are considered, and the segments reversed are strictly inside it,
+ * so the threads write disjoint parts of the tour. The nodes with a candidate in another sub-path stay pending
+ * for the next round, the other ones are examined again only when one of their edges changes.
+ *
+ * @param param The data of the thread, a two_opt_chunk_data (input/output)
+ *
+ * @return 0
+ */
+DWORD WINAPI two_opt_chunk_worker(LPVOID param);
+
+/**
+ * Reverse the nodes of the tour from position i to position j, updating their positions.
+ *
+ * @param nodes The visited nodes of the solution (input/output)
+ * @param pos The position of each node (input/output)
+ * @param i The first position (input)
+ * @param j The last position (input)
+ */
+void reverse_positions(int *nodes, int *pos, const int i, const int j);
+
+/**
+ * Check if the local searches asked for an instance use the candidate lists.
+ *
+ * @param inst The instance with the local searches asked (input)
+ *
+ * @return True if the candidate lists are needed, false otherwise
+ */
+bool local_search_needs_candidates(const instance *inst);
+
+/**
+ * Find a local search in the registry.
+ *
+ * @param type The local search (input)
+ *
+ * @return The entry of the local search, the one of 2-opt if the type is unknown
+ */
+const ls_operator *find_local_search(const LocalSearchType type);
+
+/**
+ * Return the name of a local search.
+ *
+ * @param type The local search (input)
+ *
+ * @return The name of the local search, as given with -ls
+ */
+const char *local_search_name(const LocalSearchType type);
+
+/**
+ * Read the name of a local search.
+ *
+ * @param name The name, as given with -ls (input)
+ * @param type The local search (output)
+ *
+ * @return True if the name is a local search, false otherwise
+ */
+bool parse_local_search(const char *name, LocalSearchType *type);
+
+/**
+ * Read a chain of local searches: their names separated by commas (e.g. "2opt_nl,oropt,dp").
+ *
+ * @param spec The chain, as given with -ls (input)
+ * @param chain The chain of local searches (output)
+ *
+ * @return True if the names are local searches and they are at most LS_MAX_CHAIN, false otherwise
+ */
+bool parse_local_search_chain(const char *spec, ls_chain *chain);
+
+/**
+ * Write the name of a chain of local searches, as given with -ls.
+ *
+ * @param chain The chain of local searches (input)
+ * @param name The name (output)
+ * @param size The size of the name buffer (input)
+ */
+void local_search_chain_name(const ls_chain *chain, char *name, const int size);
+
+#endif //LOCAL_SEARCH_H
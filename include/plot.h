@@ -71,6 +71,7 @@ void plot_stats_in_file_base(const char* filename);
 
 /**
  * Plot the subtours in the Gnuplot file.
+ * NOTE: Nothing is plotted if the instance has no coordinates.
  * 
  * @param inst The instance that contains the problem data (input)
  * @param subtours The array of subtours (input)
@@ -111,7 +111,8 @@ void reset_tabu_list_if_full(tabu_params *params, const instance *inst);
  * @param inst The instance that contains the problem data (input)
  * @param sol TThe solution to modify (input/output)
  * @param params The tabu search parameters (input/output)
+ * @param scan The working memory of the 2-opt scan (input/output)
  */
-void move_to_best_neighbor(const instance *inst, solution *current, tabu_params *params);
+void move_to_best_neighbor(const instance *inst, solution *current, tabu_params *params, two_opt_scan *scan);
 
 #endif //TABU_SEARCH_H
\ No newline at end of file
@@ -0,0 +1,372 @@
+#ifndef TOUR_H
+#define TOUR_H
+
+#include "tsp.h"
+#include "utilities.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+// Segments of the two-level list are rebuilt when one grows to this many times the initial size
+#define TWO_LEVEL_MAX_GROWTH 4
+
+// Sequence numbers of the two-level list are renumbered when they pass this bound
+#define TWO_LEVEL_ID_BOUND (1 << 30)
+
+/**
+ * Initialize a tour on the visited nodes of a solution: a two-level list if the instance has at least
+ * inst->two_level_min nodes (and two_level_min is positive), an array otherwise.
+ * NOTE: The moves of the tour change the visited nodes of the solution (after tour_to_solution() for the
+ *       two-level list), but not its cost.
+ *
+ * @param t The tour to initialize (output)
+ * @param sol The solution whose nodes are used (input/output)
+ * @param inst The instance (input)
+ */
+void tour_init(tour *t, solution *sol, const instance *inst);
+
+/**
+ * Start keeping the log of the 2-opt moves applied to the tour, so that they can be undone with tour_undo().
+ * NOTE: All the moves are 2-opt moves (Or-opt and 3-opt moves are applied as 2-opt moves), so all of them are logged.
+ *
+ * @param t The tour (input/output)
+ */
+void tour_start_log(tour *t);
+
+/**
+ * Undo the moves of the log after the first mark ones (the mark is the log_len before the moves), newest first.
+ *
+ * @param t The tour (input/output)
+ * @param mark The number of moves to keep (input)
+ */
+void tour_undo(tour *t, const int mark);
+
+/**
+ * Write the tour in the visited nodes of the solution given to tour_init(), with the closing node.
+ * NOTE: For the array representation the nodes are already the ones of the tour: nothing is done.
+ *
+ * @param t The tour (input)
+ */
+void tour_to_solution(const tour *t);
+
+/**
+ * Free the memory of a tour (not the nodes of the solution).
+ *
+ * @param t The tour to free (input/output)
+ */
+void tour_free(tour *t);
+
+/**
+ * Build the two-level list of a tour from the order of its nodes, with segments of about sqrt(n) nodes.
+ * NOTE: The memory must be already allocated.
+ *
+ * @param t The tour (input/output)
+ * @param order The nodes in the order of the tour (input)
+ */
+void two_level_build(tour *t, const int *order);
+
+/**
+ * Reverse the path of a two-level list from node a forward to node b, both included.
+ * The shorter of the path and the rest of the tour is reversed: the ends of the path are split from their segments,
+ * moving the smaller part of each segment to its neighbour, then the segments in between are reversed as a whole.
+ *
+ * @param t The tour (input/output)
+ * @param a The first node of the path (input)
+ * @param b The last node of the path (input)
+ */
+void two_level_reverse(tour *t, const int a, const int b);
+
+/**
+ * Reverse the path from node a forward to node b inside a segment of a two-level list, relinking its nodes.
+ *
+ * @param t The tour (input/output)
+ * @param a The first node of the path (input)
+ * @param b The last node of the path (input)
+ */
+void two_level_reverse_inside(tour *t, const int a, const int b);
+
+/**
+ * Reverse the segments of a two-level list from segment sa forward to segment sb: their order in the tour
+ * is reversed and their reversal bits are flipped.
+ *
+ * @param t The tour (input/output)
+ * @param sa The first segment (input)
+ * @param sb The last segment (input)
+ */
+void two_level_reverse_segments(tour *t, const int sa, const int sb);
+
+/**
+ * Move the nodes of a segment of a two-level list, from its first node in the tour to node x,
+ * at the end of the segment before it.
+ *
+ * @param t The tour (input/output)
+ * @param x The last node to move (input)
+ */
+void two_level_move_to_prev(tour *t, const int x);
+
+/**
+ * Move the nodes of a segment of a two-level list, from node x to its last node in the tour,
+ * at the beginning of the segment after it.
+ *
+ * @param t The tour (input/output)
+ * @param x The first node to move (input)
+ */
+void two_level_move_to_next(tour *t, const int x);
+
+/**
+ * Renumber the nodes of a segment of a two-level list from 0, along the orientation of the segment.
+ *
+ * @param t The tour (input/output)
+ * @param s The segment (input)
+ */
+void two_level_renumber(tour *t, const int s);
+
+/**
+ * Reverse the path of the tour from node a forward to node b, both included.
+ * If the path is longer than half of the tour, the rest of the tour is reversed instead: the cycle obtained is the same,
+ * with the opposite orientation.
+ *
+ * @param t The tour (input/output)
+ * @param a The first node of the path (input)
+ * @param b The last node of the path (input)
+ */
+void tour_reverse(tour *t, const int a, const int b);
+
+/**
+ * Apply the 2-opt move that replaces the edges (a, b) and (c, d) with (a, c) and (b, d).
+ * The move does not depend on the orientation of the tour, so that moves can be chained (e.g. an Or-opt move).
+ * NOTE: This function assumes that b and d are on the same side of a and c: b = next(a) and d = next(c),
+ *       or b = prev(a) and d = prev(c).
+ *
+ * @param t The tour (input/output)
+ * @param a The first node of the first edge (input)
+ * @param b The second node of the first edge (input)
+ * @param c The first node of the second edge (input)
+ * @param d The second node of the second edge (input)
+ */
+void tour_2opt_move(tour *t, const int a, const int b, const int c, const int d);
+
+/**
+ * Apply the Or-opt move that moves the path from s1 forward to s2 between c and d = next(c),
+ * as c -> s1 ... s2 -> d or, if reversed, as c -> s2 ... s1 -> d.
+ * The move is applied as two or three 2-opt moves, without allocating memory.
+ * NOTE: This function assumes that c and d are not in the path.
+ *
+ * @param t The tour (input/output)
+ * @param s1 The first node of the path (input)
+ * @param s2 The last node of the path (input)
+ * @param c The node before the new position (input)
+ * @param d The node after the new position (input)
+ * @param reversed True to insert the path reversed (input)
+ */
+void tour_or_move(tour *t, const int s1, const int s2, const int c, const int d, const bool reversed);
+
+/**
+ * Find the reconnection of the sequential 3-opt move that removes the edges (t1, t2), (t3, t4), (t5, t6)
+ * and adds the edges (t2, t3), (t4, t5), (t6, t1).
+ *
+ * @param t The tour (input)
+ * @param x The nodes t1, ..., t6 of the move (input)
+ * @param abc The first nodes a, b, c of the removed edges, in the order of the tour (output)
+ *
+ * @return The reconnection, RECONNECT_INVALID if the move does not give a tour
+ */
+Reconnection tour_3opt_reconnection(const tour *t, const int *x, int *abc);
+
+/**
+ * Apply a 3-opt move that changes all the three edges, as two or three 2-opt moves, without allocating memory.
+ *
+ * @param t The tour (input/output)
+ * @param a The first node of the first removed edge (input)
+ * @param b The first node of the second removed edge (input)
+ * @param c The first node of the third removed edge (input)
+ * @param type The reconnection (input)
+ */
+void tour_3opt_move(tour *t, const int a, const int b, const int c, const Reconnection type);
+
+/**
+ * Apply the double bridge that removes the edges (a, a'), (b, b'), (c, c'), (d, d'), with a, b, c, d in the order
+ * of the tour and x' = next(x): the tour a [a' ... b] [b' ... c] [c' ... d] d' becomes a [c' ... d] [b' ... c] [a' ... b] d'.
+ * The move is non-sequential, so a sequence of 2-opt moves from one node (e.g. a Lin-Kernighan move) cannot undo it.
+ * It is applied as up to four 2-opt moves, without allocating memory.
+ *
+ * @param t The tour (input/output)
+ * @param a The first node of the first removed edge (input)
+ * @param b The first node of the second removed edge (input)
+ * @param c The first node of the third removed edge (input)
+ * @param d The first node of the fourth removed edge (input)
+ */
+void tour_double_bridge(tour *t, const int a, const int b, const int c, const int d);
+
+/**
+ * Check if two edges are the same edge.
+ *
+ * @param u The first node of the first edge (input)
+ * @param v The second node of the first edge (input)
+ * @param x The first node of the second edge (input)
+ * @param y The second node of the second edge (input)
+ *
+ * @return True if the edges are the same, false otherwise
+ */
+static inline bool same_edge(const int u, const int v, const int x, const int y) {
+
+    return (u == x && v == y) || (u == y && v == x);
+
+}
+
+/**
+ * Initialize a work queue with all the nodes, in the order given.
+ *
+ * @param q The queue (output)
+ * @param nodes The nodes, e.g. the ones of a tour (input)
+ * @param n The number of nodes (input)
+ */
+void queue_init(work_queue *q, const int *nodes, const int n);
+
+/**
+ * Free the memory of a work queue.
+ *
+ * @param q The queue (input/output)
+ */
+void queue_free(work_queue *q);
+
+/**
+ * Append a node to a work queue, if it is not already queued (switch off its don't-look bit).
+ *
+ * @param q The queue (input/output)
+ * @param node The node (input)
+ */
+void queue_push(work_queue *q, const int node);
+
+/**
+ * Remove the first node of a work queue (switch on its don't-look bit).
+ * NOTE: This function assumes that the queue is not empty.
+ *
+ * @param q The queue (input/output)
+ *
+ * @return The node
+ */
+int queue_pop(work_queue *q);
+
+/**
+ * Return the first node of a segment of a two-level list, in the order of the tour.
+ *
+ * @param t The tour (input)
+ * @param s The segment (input)
+ *
+ * @return The first node of the segment
+ */
+static inline int segment_head(const tour *t, const int s) {
+
+    return t->seg_reversed[s] ? t->seg_last[s] : t->seg_first[s];
+
+}
+
+/**
+ * Return the last node of a segment of a two-level list, in the order of the tour.
+ *
+ * @param t The tour (input)
+ * @param s The segment (input)
+ *
+ * @return The last node of the segment
+ */
+static inline int segment_tail(const tour *t, const int s) {
+
+    return t->seg_reversed[s] ? t->seg_first[s] : t->seg_last[s];
+
+}
+
+/**
+ * Return the key of a node in a two-level list: the keys increase along the tour, from the segment of rank 0.
+ *
+ * @param t The tour (input)
+ * @param node The node (input)
+ *
+ * @return The key of the node
+ */
+static inline long long two_level_key(const tour *t, const int node) {
+
+    int s = t->seg[node];
+
+    return ((long long) t->seg_rank[s] << 33) + (t->seg_reversed[s] ? -t->id[node] : t->id[node]);
+
+}
+
+/**
+ * Return the node after a node in the tour.
+ *
+ * @param t The tour (input)
+ * @param node The node (input)
+ *
+ * @return The successor of the node
+ */
+static inline int tour_next(const tour *t, const int node) {
+
+    if (!t->two_level) return t->nodes[t->pos[node] + 1];
+
+    int s = t->seg[node];
+
+    if (!t->seg_reversed[s]) return (node == t->seg_last[s]) ? segment_head(t, t->seg_next[s]) : t->link_next[node];
+    return (node == t->seg_first[s]) ? segment_head(t, t->seg_next[s]) : t->link_prev[node];
+
+}
+
+/**
+ * Return the node before a node in the tour.
+ *
+ * @param t The tour (input)
+ * @param node The node (input)
+ *
+ * @return The predecessor of the node
+ */
+static inline int tour_prev(const tour *t, const int node) {
+
+    if (!t->two_level) {
+
+        int p = t->pos[node];
+
+        return t->nodes[(p == 0) ? t->n - 1 : p - 1];
+
+    }
+
+    int s = t->seg[node];
+
+    if (!t->seg_reversed[s]) return (node == t->seg_first[s]) ? segment_tail(t, t->seg_prev[s]) : t->link_prev[node];
+    return (node == t->seg_last[s]) ? segment_tail(t, t->seg_prev[s]) : t->link_next[node];
+
+}
+
+/**
+ * Check if node b is on the path of the tour from node a forward to node c, both included.
+ *
+ * @param t The tour (input)
+ * @param a The first node of the path (input)
+ * @param b The node to check (input)
+ * @param c The last node of the path (input)
+ *
+ * @return True if b is between a and c, false otherwise
+ */
+static inline bool tour_between(const tour *t, const int a, const int b, const int c) {
+
+    long long pa, pb, pc;
+
+    if (t->two_level) {
+
+        pa = two_level_key(t, a);
+        pb = two_level_key(t, b);
+        pc = two_level_key(t, c);
+
+    } else {
+
+        pa = t->pos[a];
+        pb = t->pos[b];
+        pc = t->pos[c];
+
+    }
+
+    return (pa <= pc) ? (pa <= pb && pb <= pc) : (pb >= pa || pb <= pc);
+
+}
+
+#endif //TOUR_H
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdbool.h>
 
 // Default values for the instance
 #define DEFAULT_NNODES 150
@@ -13,6 +14,19 @@
 #define DEFAULT_VERBOSE 50
 #define EMPTY_STRING '\0'
 #define DEFAULT_PARAMETER -1
+#define DEFAULT_COST_MEMORY 4096.0      // Memory budget in MB for the cost matrix
+#define DEFAULT_THREADS 0               // Number of threads, 0 means one for each processor
+#define DEFAULT_CANDIDATES 0            // Length of the candidate lists, 0 means no lists
+#define DEFAULT_HILBERT 0               // Renumber the nodes along a Hilbert curve, 0 means no
+#define DEFAULT_CACHE 0                 // Use the binary cache of the input file, 0 means no
+#define DEFAULT_COST_LAYOUT LAYOUT_TRIANGULAR // Storage layout of the cost matrix
+#define DEFAULT_LOCAL_SEARCH LS_2OPT    // Local search used by the methods
+#define LS_MAX_CHAIN 8                  // Maximum number of local searches in a chain (-ls)
+#define DEFAULT_OR_OPT 0                // Chain Or-opt after the local search, 0 means no
+#define DEFAULT_TWO_LEVEL_MIN 50000    // Number of nodes from which the local searches use the two-level list tour
+#define DEFAULT_LK_DEPTH 50             // Maximum number of steps of a Lin-Kernighan move
+#define DEFAULT_DP_WINDOW 0             // Window of the DP re-optimization chained after the local search, 0 means no
+#define DEFAULT_LS_CANDIDATES 10        // Length of the candidate lists built for the neighbor-list local searches, if not given
 
 // Values limit
 #define MIN_NNODES 10                   // Minimum number of nodes
@@ -30,6 +44,12 @@
 #define METH_NAME_LEN 30
 #define INST_NAME_LEN 50
 #define FILE_NAME_LEN 1000
+#define SIMD_ALIGNMENT 64               // Alignment in bytes of the coordinate arrays (one cache line)
+#define SIMD_WIDTH 8                    // Doubles in a SIMD_ALIGNMENT block: the coordinate arrays are padded to a multiple of it
+#define HILBERT_ORDER 16                // Bits for each coordinate of the Hilbert curve grid
+#define COST_TILE_BITS 6                // log2 of the side of a tile of the tiled cost matrix
+#define COST_TILE (1 << COST_TILE_BITS) // Side of a tile of the tiled cost matrix (64 x 64 costs)
+#define KOPT_MAX_K 5                    // Maximum number of edges removed by a k-opt move given as a kopt_move
 
 // Structure to hold coordinate values
 typedef struct {
@@ -39,27 +59,138 @@ typedef struct {
 
 } coordinate;
 
+// Type used to store the edges' cost, selected at build time (see TSP_COST_TYPE in CMakeLists.txt)
+// NOTE: The costs of a tour are always accumulated in double precision
+#if defined(COST_TYPE_FLOAT)
+typedef float cost_t;
+#define COST_TYPE_NAME "float"
+#elif defined(COST_TYPE_INT32)
+typedef int cost_t;
+#define COST_TYPE_NAME "int32"
+#else
+typedef double cost_t;
+#define COST_TYPE_NAME "double"
+#endif
+
+// Enum for edge weight types (TSPLIB EDGE_WEIGHT_TYPE)
+typedef enum {
+
+    EUCLIDEAN,              // Real valued Euclidean distance (used for random instances)
+    EUC_2D,                 // Euclidean distance rounded to the nearest integer
+    CEIL_2D,                // Euclidean distance rounded up to the next integer
+    ATT,                    // Pseudo-Euclidean distance
+    GEO,                    // Geographical distance
+    EXPLICIT                // Weights given explicitly in the EDGE_WEIGHT_SECTION
+
+} EdgeWeightType;
+
+// Enum for the layout of explicit edge weights (TSPLIB EDGE_WEIGHT_FORMAT)
+// NOTE: The column-wise formats are read as the equivalent row-wise ones, since the costs are symmetric
+typedef enum {
+
+    FUNCTION,               // Weights computed from coordinates
+    FULL_MATRIX,            // Full n x n matrix
+    UPPER_ROW,              // Upper triangle by rows, without diagonal
+    LOWER_ROW,              // Lower triangle by rows, without diagonal
+    UPPER_DIAG_ROW,         // Upper triangle by rows, with diagonal
+    LOWER_DIAG_ROW          // Lower triangle by rows, with diagonal
+
+} EdgeWeightFormat;
+
+// Enum for the storage layouts of the cost matrix
+typedef enum {
+
+    LAYOUT_TRIANGULAR,      // Packed upper triangle by rows, in the order of xpos()
+    LAYOUT_FULL,            // Full n x n matrix by rows: twice the memory, no min/max on the lookup
+    LAYOUT_TILED            // Upper triangle of COST_TILE x COST_TILE tiles, stored along a Z-order (Morton) curve
+
+} CostLayout;
+
+// Enum for the local searches (see local_search.h)
+typedef enum {
+
+    LS_2OPT,                // Best-improvement 2-opt over all the pairs of edges
+    LS_2OPT_NL,             // 2-opt over the candidate lists, with don't-look bits
+    LS_OR_OPT,              // Or-opt over the candidate lists: segments of 1 to 3 nodes moved next to a candidate
+    LS_3OPT,                // 3-opt over the candidate lists, with don't-look bits
+    LS_LK,                  // Lin-Kernighan over the candidate lists, with don't-look bits
+    LS_2OPT_PAR,            // 2-opt over the candidate lists on sub-paths of the tour in parallel, then 2-opt over the candidate lists
+    LS_DP_WINDOW            // Exact re-optimization of windows of the tour by dynamic programming
+
+} LocalSearchType;
+
+// Structure to hold a chain of local searches, applied by Variable Neighborhood Descent (see vnd())
+typedef struct {
+
+    int len;                            // Number of local searches
+    LocalSearchType ops[LS_MAX_CHAIN];  // Local searches, from the cheapest
+
+} ls_chain;
+
+// Enum for the families of random instances (see generator.h)
+typedef enum {
+
+    GEN_RAND,               // Uniform points from rand(), the original generator
+    GEN_UNIFORM,            // Uniform points from a counter-based generator
+    GEN_CLUSTER,            // Gaussian clusters around uniform centers
+    GEN_GRID                // Perturbed square grid
+
+} GeneratorFamily;
+
 // Structure to hold solution data
 typedef struct {
 
     double cost;                        // Cost of the solution
     int *visited_nodes;                 // Sequence of visited nodes 
                                         // NOTE: to complete the cycle first and last nodes must be the same node
+    double *edge_cost;                  // Cost of the edge from each position of the tour to the next one (nnodes)
+                                        // NOTE: NULL if not cached (see cache_edge_costs()), otherwise kept up to date by the moves
     char method[METH_NAME_LEN];         // Name of method used to compute the solution
 
 } solution;
 
+// Distance kernel of an edge weight type between two points (see distances.h)
+typedef double (*distance_fn)(const double x1, const double y1, const double x2, const double y2);
+
 // Structure to hold problem data and general informations
 typedef struct {
 
     int nnodes;                         // How many nodes the graph has
-    coordinate *coord;                  // (x,y) coordinate of the nodes
-    double *costs;                      // Array of distances between nodes
+    coordinate *coord;                  // (x,y) coordinate of the nodes, NULL if the instance has no coordinates
+    double *x;                          // x coordinate of the nodes as aligned and padded array (structure of arrays)
+    double *y;                          // y coordinate of the nodes as aligned and padded array (structure of arrays)
+                                        // NOTE: NULL if the instance has no coordinates, used by the distance kernels
+    EdgeWeightType edge_weight_type;    // How the edges' cost is computed from the coordinates
+    distance_fn distance;               // Distance kernel of edge_weight_type, selected once by build_instance()
+    cost_t *costs;                      // Array of distances between nodes, stored as asked by cost_layout
+                                        // NOTE: NULL if the costs are computed on the fly from the coordinates
+    CostLayout cost_layout;             // Storage layout of the cost matrix
+    int ntiles;                         // Tiles in each row of the tiled cost matrix, ceil(nnodes / COST_TILE)
+    int *tile_index;                    // Position of tile (r, c), r <= c, in the tiled cost matrix (ntiles x ntiles, row-major)
+                                        // NOTE: NULL if the layout is not LAYOUT_TILED
+    double cost_memory;                 // Memory budget in MB for the cost matrix
+    int nthreads;                       // Number of threads for the parallel parts, 0 means one for each processor
+    int cand_k;                         // Length of the candidate lists: the K nearest nodes of each node
+    int *cand;                          // Candidate lists, K nodes for each node by increasing cost (n*K, row-major)
+    cost_t *cand_cost;                  // Costs of the candidate lists, aligned with cand
+                                        // NOTE: NULL if the lists were not asked (cand_k = 0)
+    int hilbert;                        // 1 if the nodes must be renumbered along a Hilbert curve, 0 otherwise
+    int *original_id;                   // Original id of each renumbered node, NULL if the nodes were not renumbered
+    int cache;                          // 1 if the binary cache of the input file must be used, 0 otherwise
+    void *cache_view;                   // Read-only mapping of the cache file, NULL if not loaded from it
+                                        // NOTE: costs, cand and cand_cost point inside it when it is not NULL
+    GeneratorFamily generator;          // Family of the random instance, used if there is no input file
+    ls_chain local_search;              // Chain of local searches used wherever a solution is refined
+    int or_opt;                         // 1 if Or-opt must be chained after the local search, 0 otherwise
+    int two_level_min;                  // Number of nodes from which the local searches use the two-level list, 0 for never
+    int lk_depth;                       // Maximum number of steps of a Lin-Kernighan move
+    int dp_window;                      // Nodes of the windows re-optimized by DP after the local search, 0 for none
     solution *best_solution;            // Best current solution
 
     char name[INST_NAME_LEN];           // Name of instance
     int seed;                           // Random seed
     char input_file[FILE_NAME_LEN];     // Input file 
+    char output_file[FILE_NAME_LEN];    // File where the built instance is written (TSPLIB or .tspbin), empty for none
     char asked_method[METH_NAME_LEN];   // Method to compute the solution
     int param1;                         // First parameter used by the method
     int param2;                         // Second parameter used by the method
@@ -72,4 +203,106 @@ typedef struct {
 
 } instance;
 
+// Structure to hold a tour, in one of two representations:
+// - array: the visited nodes of the solution and the position of each node in it. nodes[n] is kept equal to nodes[0],
+//   so the successor of the node at position p is always nodes[p+1]. A reversal costs O(n).
+// - two-level list: the nodes are split in about sqrt(n) segments, each a doubly-linked list of nodes with a
+//   reversal bit, and the segments are a doubly-linked list in the order of the tour.
+//   next, prev and between cost O(1), a reversal O(sqrt(n)): whole segments are reversed by flipping their bit.
+typedef struct {
+
+    int n;                  // Number of nodes
+    int *nodes;             // The visited nodes of the solution, n+1 entries (not owned): in the array representation
+                            // they are the tour, in the two-level list they are written back by tour_to_solution()
+    int *pos;               // Array: position of each node in nodes (n entries)
+
+    bool two_level;         // True for the two-level list, false for the array
+    int group_size;         // Two-level list: initial number of nodes of each segment
+    int nsegments;          // Two-level list: number of segments
+
+    int *link_prev;         // Node before each node in its segment, in the orientation of the segment
+    int *link_next;         // Node after each node in its segment, in the orientation of the segment
+    int *seg;               // Segment of each node
+    int *id;                // Sequence number of each node in its segment (consecutive, increasing along link_next)
+
+    int *seg_first;         // First node of each segment, in the orientation of the segment
+    int *seg_last;          // Last node of each segment, in the orientation of the segment
+    int *seg_size;          // Number of nodes of each segment
+    bool *seg_reversed;     // True if the tour visits the segment from its last node to its first
+    int *seg_prev;          // Segment before each segment in the tour
+    int *seg_next;          // Segment after each segment in the tour
+    int *seg_rank;          // Rank of each segment along the tour (cyclic)
+    int *run;               // Buffer for the segments of a reversal (nsegments entries)
+
+    int *log;               // Log of the 2-opt moves applied, 4 nodes each, to undo them (NULL if not kept)
+    int log_len;            // Number of moves in the log
+    int log_capacity;       // Number of moves the log can hold
+
+} tour;
+
+// Reconnections of a 3-opt move that change all the three edges: the removed edges are (a, a'), (b, b'), (c, c'),
+// with a, b, c in the order of the tour and x' = next(x), so the tour is a [a' ... b] [b' ... c] c' ... a
+// NOTE: The other three reconnections keep one of the edges: they are 2-opt moves.
+typedef enum {
+
+    RECONNECT_INVALID,              // The nodes are not a 3-opt move
+    RECONNECT_REVERSE_BOTH,         // a [b ... a'] [c ... b'] c'
+    RECONNECT_EXCHANGE,             // a [b' ... c] [a' ... b] c' (the kopt_move with order = {2, 1})
+    RECONNECT_EXCHANGE_REVERSE_1,   // a [b' ... c] [b ... a'] c'
+    RECONNECT_EXCHANGE_REVERSE_2    // a [c ... b'] [a' ... b] c'
+
+} Reconnection;
+
+// Structure to hold the work queue of the nodes whose don't-look bit is off, first in first out
+typedef struct {
+
+    int n;                  // Number of nodes, the capacity of the queue
+    int *nodes;             // Circular array of the queued nodes
+    bool *queued;           // True if the node is in the queue (don't-look bit off)
+    int head;               // Position of the first node
+    int count;              // Number of queued nodes
+
+} work_queue;
+
+// Structure to hold a k-opt move on the array of the visited nodes: the edges (idx[i], idx[i]+1) are removed,
+// and the k-1 segments between them are put back in a new order, each possibly reversed.
+// The segments are numbered from 1: segment s goes from index idx[s-1]+1 to index idx[s].
+// E.g. the segment exchange A -> C -> B (RECONNECT_EXCHANGE on the tour) is k = 3, order = {2, 1}, reversed = {false, false}.
+typedef struct {
+
+    int k;                              // Number of removed edges, at most KOPT_MAX_K
+    int idx[KOPT_MAX_K];                // Indices of the removed edges, sorted
+    int order[KOPT_MAX_K - 1];          // Segments in their new order
+    bool reversed[KOPT_MAX_K - 1];      // True if the segment in that place of the new order is reversed
+
+} kopt_move;
+
+// Working memory of the 2-opt neighbourhood scan (see two_opt_scan_row()), allocated once for each local search.
+// With SIMD_AVX2 or SIMD_SSE2 and coordinates, the deltas of a row are computed from the coordinates in tour order
+// with the vector distance kernels, otherwise with delta2() for each move.
+typedef struct {
+
+    const solution *sol;                // Solution whose tour is loaded
+    bool vectorized;                    // True if the deltas are computed from the coordinates in tour order
+    double *x;                          // x coordinates in tour order, nnodes + 1 of them (the tour is closed)
+    double *y;                          // y coordinates in tour order, nnodes + 1 of them (the tour is closed)
+    double *edge;                       // Cost of the edge of the tour from each position to the next one
+    cost_t *row_prev;                   // Costs from the node at i-1 to the nodes at j
+    cost_t *row_next;                   // Costs from the node at i to the nodes at j+1
+    double *delta;                      // Deltas of the moves of the row
+    long long moves;                    // Number of moves evaluated
+
+} two_opt_scan;
+
+// Structure to hold the tables of the Held-Karp dynamic programming over the paths from start to end,
+// allocated once for the largest number of inner nodes and reused for each path
+typedef struct {
+
+    int max_inner;          // Largest number of inner nodes
+    double *table;          // Cost of the best path from start through the nodes of mask, ending at inner node j (mask * m + j)
+    unsigned char *parent;  // Inner node before j on that path, aligned with table
+    double *dist;           // Costs between the inner nodes (m x m), then from start and to end (m each)
+
+} held_karp;
+
 #endif //TSP_H
\ No newline at end of file
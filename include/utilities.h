@@ -5,6 +5,7 @@
 #include "heuristics.h"
 #include "utilities_instance.h"
 #include "utilities_solution.h"
+#include "distances.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -51,20 +52,20 @@ double get_elapsed_time(const double start);
 double get_time_in_milliseconds();
 
 /**
- * Draw a random value between 0 and 1.
+ * Get the number of threads to use: the one asked, or one for each processor.
+ * NOTE: Windows only.
  * 
- * @return The random value
+ * @param inst The instance with the asked number of threads (input)
+ * 
+ * @return The number of threads
  */
-double random01(void);
+int get_number_of_threads(const instance *inst);
 
 /**
- * Compute the Euclidean distance between two points.
- * 
- * @param point1 The first point (input)
- * @param point2 The second point (input)
+ * Draw a random value between 0 and 1.
  * 
- * @return The distance between the points
+ * @return The random value
  */
-double dist(const coordinate point1, const coordinate point2);
+double random01(void);
 
 #endif //UTILITIES_H
\ No newline at end of file
@@ -3,10 +3,45 @@
 
 #include "tsp.h"
 #include "utilities.h"
+#include "distances.h"
+#include "kd_tree.h"
+#include "instance_cache.h"
+#include "generator.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include <malloc.h>
+#include <limits.h>
+#include <stdbool.h>
+
+// Rows of the cost matrix computed by a thread before moving to the next block
+#define COST_ROWS_BLOCK 64
+
+// Size in bytes of the buffer of a TSPLIB file being written
+#define TSPLIB_WRITE_BUFFER (1 << 20)
+
+// Largest decimal exponent read by scan_double(), far beyond the range of a double
+#define SCAN_MAX_EXPONENT 100000
+
+// Structure to hold a node with its position along the Hilbert curve
+typedef struct {
+
+    unsigned long long key; // Position of the cell of the node along the curve
+    int id;                 // Id of the node
+
+} hilbert_node;
+
+// Structure to hold the data of a thread computing the costs
+typedef struct {
+
+    instance *inst;         // The instance whose costs are computed
+    int thread_id;          // Index of the thread, from 0 to nthreads-1
+    int nthreads;           // Number of threads computing the costs
+
+} cost_worker_data;
 
 /**
  * Initialize the instance with default values.
@@ -19,8 +54,9 @@ void initialize_instance(instance *inst);
 /**
  * Instantiate a TSP problem: 
  * - it allocates the memory for the instance;
- * - if an input file is provided, it parses the file and fills the instance with the data;
- *   otherwise it generates a random instance.
+ * - if an input file is provided, it parses the file (or loads it, if it is a .tspbin file) and fills the instance with the data;
+ *   otherwise it generates a random instance of the family asked;
+ * - if an output file is provided, it writes the built instance.
  * 
  * @param inst The instance to fill with the data (input/output)
  */
@@ -35,14 +71,96 @@ void build_instance(instance *inst);
 void random_instance_generator(instance *inst);
 
 /**
- * Parse a TSPLIB format file to extract only node coordinates.
- * NOTE: This function assumes a standard TSPLIB format where DIMENSION appears before NODE_COORD_SECTION.
+ * Write the built instance in the output file: a .tspbin file (see instance_cache.h) or a TSPLIB file.
+ * 
+ * @param inst The built instance with the output file (input)
+ */
+void write_instance(const instance *inst);
+
+/**
+ * Write the coordinates of the instance as a TSPLIB file, with the nodes in their original order.
+ * NOTE: Only instances with a TSPLIB edge weight type computed from the coordinates can be written.
+ * 
+ * @param inst The instance (input)
+ * @param filename The path of the file (input)
+ */
+void write_tsplib_file(const instance *inst, const char *filename);
+
+/**
+ * Parse a TSPLIB format file to extract the node coordinates or the explicit edge weights.
+ * The file is memory-mapped and scanned in a single pass, numbers are read by a custom scanner.
+ * NOTE: This function assumes a standard TSPLIB format where the specification part comes before the data sections.
  * NOTE: This function assumes that the input file is already set in the instance structure.
  * NOTE: This function allocates the memory for the instance.
  * 
  * @param inst The instance to fill with the data (input/output)
  */
-void basic_TSPLIB_parser(instance *inst);
+void TSPLIB_parser(instance *inst);
+
+/**
+ * Read the EDGE_WEIGHT_SECTION of a TSPLIB file, storing each value directly in the costs.
+ * NOTE: This function assumes that the costs are already allocated.
+ * 
+ * @param inst The instance to fill with the costs (input/output)
+ * @param format The layout of the weights in the section (input)
+ * @param p The current position in the text, moved after the section (input/output)
+ * @param end The end of the text (input)
+ */
+void parse_edge_weight_section(instance *inst, const EdgeWeightFormat format, const char **p, const char *end);
+
+/**
+ * Skip spaces and tabs, but not the end of line.
+ * 
+ * @param p The current position in the text, it is moved forward (input/output)
+ * @param end The end of the text (input)
+ */
+void skip_blanks(const char **p, const char *end);
+
+/**
+ * Skip everything up to and including the end of line.
+ * 
+ * @param p The current position in the text, it is moved forward (input/output)
+ * @param end The end of the text (input)
+ */
+void skip_line(const char **p, const char *end);
+
+/**
+ * Check if the keyword read from the file is exactly the expected one.
+ * NOTE: The keyword is not null-terminated.
+ * 
+ * @param keyword The keyword read from the file (input)
+ * @param len The length of the keyword (input)
+ * @param expected The expected keyword (input)
+ * 
+ * @return true if the keywords match, false otherwise
+ */
+bool keyword_matches(const char *keyword, const size_t len, const char *expected);
+
+/**
+ * Read a (signed) integer, skipping any leading white space.
+ * NOTE: A number that does not fit in a long (32 bits on Windows) is not read.
+ * 
+ * @param p The current position in the text, moved after the number if it is read (input/output)
+ * @param end The end of the text (input)
+ * @param value The value read (output)
+ * 
+ * @return true if a number is read, false otherwise (also if it overflows)
+ */
+bool scan_int(const char **p, const char *end, long *value);
+
+/**
+ * Read a floating point number, also in scientific notation, skipping any leading white space.
+ * NOTE: Values whose digits form an integer mantissa below 2^53 and whose decimal exponent is between -22 and 22
+ *       are converted exactly, the others (of any length) are handed to strtod().
+ * NOTE: A number with an exponent beyond SCAN_MAX_EXPONENT (or one that does not fit in a long) is not read.
+ * 
+ * @param p The current position in the text, moved after the number if it is read (input/output)
+ * @param end The end of the text (input)
+ * @param value The value read (output)
+ * 
+ * @return true if a number is read, false otherwise
+ */
+bool scan_double(const char **p, const char *end, double *value);
 
 /**
  * Give a name to the instance:
@@ -55,14 +173,207 @@ void name_instance(instance *inst);
 
 /**
  * Compute the distance between every node to every node in the instance.
+ * NOTE: The distance kernel is chosen once from the edge weight type of the instance.
+ * NOTE: Explicit instances are skipped, their costs are read from the file.
+ * NOTE: Only the upper triangle is computed, with its rows spread across the threads.
  * 
  * @param inst The instance to compute the costs for (input/output)
  */
 void compute_all_costs(instance *inst);
 
+/**
+ * Compute the rows of the cost matrix assigned to a thread: blocks of COST_ROWS_BLOCK rows, one every nthreads.
+ * NOTE: Threads write disjoint parts of the cost matrix, so they need no synchronization.
+ * 
+ * @param param The data of the thread, a cost_worker_data (input/output)
+ * 
+ * @return Always 0
+ */
+DWORD WINAPI compute_costs_worker(LPVOID param);
+
+/**
+ * Build the position of each tile of the tiled cost matrix: the tiles of the upper triangle (r <= c)
+ * are numbered along a Z-order curve, so that near tiles are near in memory in both directions.
+ * NOTE: Nothing is done if the layout is not LAYOUT_TILED.
+ * 
+ * @param inst The instance with the number of nodes and the layout (input/output)
+ */
+void build_tile_index(instance *inst);
+
+/**
+ * Build the candidate lists of the instance: the cand_k nearest nodes of each node, by increasing cost.
+ * NOTE: Coordinate instances use a kd-tree, O(n log n) to build and O(K log n) expected for each list
+ *       (more nodes are asked when rounded costs tie with the K-th);
+ *       GEO and EXPLICIT instances, whose costs are not ordered as the plane distances, scan the full rows.
+ * NOTE: Nothing is done if cand_k is 0, and cand_k is reduced to nnodes-1 if it is greater.
+ * 
+ * @param inst The instance to build the lists for (input/output)
+ */
+void build_candidate_lists(instance *inst);
+
+/**
+ * Sort a candidate list by increasing cost, ties by increasing index (insertion sort, the lists are short).
+ * 
+ * @param list The nodes of the list (input/output)
+ * @param list_cost The costs of the list, aligned with the nodes (input/output)
+ * @param k The length of the list (input)
+ */
+void sort_candidate_list(int *list, cost_t *list_cost, const int k);
+
+/**
+ * Renumber the nodes in the order of a Hilbert curve over their coordinates, so that near nodes have near ids:
+ * their coordinates and costs are then close in memory.
+ * NOTE: The original id of each node is kept in original_id, see restore_node_numbering().
+ * NOTE: Instances with explicit costs are not renumbered.
+ * 
+ * @param inst The instance to renumber (input/output)
+ */
+void renumber_nodes_hilbert(instance *inst);
+
+/**
+ * Compute the position of a cell of the 2^HILBERT_ORDER x 2^HILBERT_ORDER grid along the Hilbert curve.
+ * 
+ * @param x The column of the cell (input)
+ * @param y The row of the cell (input)
+ * 
+ * @return The position of the cell along the curve
+ */
+unsigned long long hilbert_key(unsigned int x, unsigned int y);
+
+/**
+ * Compare two hilbert_node by their position along the curve, then by id (for qsort).
+ * 
+ * @param a The first node (input)
+ * @param b The second node (input)
+ * 
+ * @return Negative, zero or positive if the first node comes before, with or after the second one
+ */
+int compare_hilbert_nodes(const void *a, const void *b);
+
+/**
+ * Map a solution back to the original ids of the nodes, and the instance with it.
+ * NOTE: The costs and the candidate lists of the renumbered nodes are dropped: after this, costs are computed on the fly.
+ * NOTE: Nothing is done if the nodes were not renumbered.
+ * 
+ * @param inst The renumbered instance (input/output)
+ * @param sol The solution in the renumbered ids (input/output)
+ */
+void restore_node_numbering(instance *inst, solution *sol);
+
+/**
+ * Copy the coordinates of the nodes in the aligned and padded arrays x and y of the instance (structure of arrays).
+ * NOTE: coord is kept, the arrays are the layout read by the distance kernels.
+ * NOTE: Instances without coordinates are skipped.
+ * 
+ * @param inst The instance with the coordinates to copy (input/output)
+ */
+void build_coordinate_arrays(instance *inst);
+
+/**
+ * Return the number of edges of the complete graph, i.e. the length of the packed cost matrix.
+ * 
+ * @param nnodes The number of nodes (input)
+ * 
+ * @return The number of edges
+ */
+static inline size_t number_of_edges(const int nnodes) {
+
+    return (size_t) nnodes * (nnodes - 1) / 2;
+
+}
+
+/**
+ * Compute the position of edge (i,j) in the packed upper triangle of the cost matrix.
+ * NOTE: This is the same index of the edge variable in the CPLEX model, see xpos().
+ * NOTE: This function assumes i < j.
+ * 
+ * @param i The first node (input)
+ * @param j The second node (input)
+ * @param nnodes The number of nodes (input)
+ * 
+ * @return The edge index
+ */
+static inline size_t edge_index(const int i, const int j, const int nnodes) {
+
+    return (size_t) i * nnodes + j - ((size_t) (i + 1) * (i + 2)) / 2;
+
+}
+
+/**
+ * Compute the distance between two nodes from their coordinates, as it would be stored in the cost matrix.
+ * NOTE: The kernel is the one selected by build_instance() (inst->distance), with no switch on the edge weight type.
+ * NOTE: This function assumes that the instance has coordinates and that i and j are valid indices.
+ * 
+ * @param i The first node (input)
+ * @param j The second node (input)
+ * @param inst The instance containing the coordinates (input)
+ * 
+ * @return The distance between the two nodes
+ */
+static inline double compute_cost(const int i, const int j, const instance *inst) {
+
+    return (double) to_cost(inst->distance(inst->x[i], inst->y[i], inst->x[j], inst->y[j]));
+
+}
+
+/**
+ * Return the number of costs stored by a cost matrix layout, padding included.
+ * 
+ * @param nnodes The number of nodes (input)
+ * @param layout The layout of the cost matrix (input)
+ * 
+ * @return The number of costs
+ */
+static inline size_t cost_matrix_size(const int nnodes, const CostLayout layout) {
+
+    size_t ntiles = ((size_t) nnodes + COST_TILE - 1) / COST_TILE;
+
+    switch (layout) {
+
+        case LAYOUT_FULL:   return (size_t) nnodes * nnodes;
+        case LAYOUT_TILED:  return ntiles * (ntiles + 1) / 2 * COST_TILE * COST_TILE;
+        default:            return number_of_edges(nnodes);
+
+    }
+
+}
+
+/**
+ * Compute the position of edge (i,j) in the cost matrix, for the layout of the instance.
+ * NOTE: This function assumes i != j and, for the tiled layout, that the tile index is built.
+ * 
+ * @param i The first node (input)
+ * @param j The second node (input)
+ * @param inst The instance containing the costs (input)
+ * 
+ * @return The position of the cost of the edge
+ */
+static inline size_t cost_index(const int i, const int j, const instance *inst) {
+
+    // Full matrix: both (i,j) and (j,i) are stored
+    if (inst->cost_layout == LAYOUT_FULL) return (size_t) i * inst->nnodes + j;
+
+    // Select the smaller node as row without branching
+    int row = (i < j) ? i : j;
+    int col = (i < j) ? j : i;
+
+    if (inst->cost_layout == LAYOUT_TILED) {
+
+        // Tile of the edge, then row-major position inside the tile
+        size_t tile = (size_t) inst->tile_index[(row >> COST_TILE_BITS) * inst->ntiles + (col >> COST_TILE_BITS)];
+        return (tile << (2 * COST_TILE_BITS)) + ((size_t) (row & (COST_TILE - 1)) << COST_TILE_BITS) + (col & (COST_TILE - 1));
+
+    }
+
+    return edge_index(row, col, inst->nnodes);
+
+}
+
 /**
  * Return the distance between two nodes wrt the given instance.
  * NOTE: This function assumes that the costs have already been computed and that i and j are valid indices.
+ * NOTE: Without cost matrix (matrix-free mode) the distance is computed on the fly from the coordinates.
+ * NOTE: The self-to-self distance is INF.
  * 
  * @param i The first node (input)
  * @param j The second node (input)
@@ -70,7 +381,56 @@ void compute_all_costs(instance *inst);
  * 
  * @return The distance between the two nodes
  */
-double cost(const int i, const int j, const instance *inst);
+static inline double cost(const int i, const int j, const instance *inst) {
+
+    if (i == j) return INFINITY;
+
+    if (inst->costs == NULL) return compute_cost(i, j, inst);
+
+    return (double) inst->costs[cost_index(i, j, inst)];
+
+}
+
+/**
+ * Return the candidate list of a node: its cand_k nearest nodes, by increasing cost.
+ * NOTE: This function assumes that i is a valid index.
+ * 
+ * @param i The node (input)
+ * @param inst The instance containing the candidate lists (input)
+ * 
+ * @return The first of the cand_k nodes of the list, NULL if the lists were not built
+ */
+static inline const int *candidates(const int i, const instance *inst) {
+
+    return (inst->cand == NULL) ? NULL : &inst->cand[(size_t) i * inst->cand_k];
+
+}
+
+/**
+ * Return the costs of the candidate list of a node, aligned with candidates().
+ * NOTE: This function assumes that i is a valid index.
+ * 
+ * @param i The node (input)
+ * @param inst The instance containing the candidate lists (input)
+ * 
+ * @return The first of the cand_k costs of the list, NULL if the lists were not built
+ */
+static inline const cost_t *candidate_costs(const int i, const instance *inst) {
+
+    return (inst->cand_cost == NULL) ? NULL : &inst->cand_cost[(size_t) i * inst->cand_k];
+
+}
+
+/**
+ * Set the distance between two nodes w.r.t. the given instance, in both directions.
+ * NOTE: This function assumes that the costs have already been allocated and that i and j are valid indices.
+ * 
+ * @param i The first node (input)
+ * @param j The second node (input)
+ * @param value The distance between the two nodes (input)
+ * @param inst The instance containing the costs (input/output)
+ */
+void set_cost(const int i, const int j, const double value, instance *inst);
 
 /**
  * Print the instance.
@@ -79,9 +439,39 @@ double cost(const int i, const int j, const instance *inst);
  */
 void print_instance(const instance *inst);
 
+/**
+ * Return the TSPLIB name of the edge weight type.
+ * 
+ * @param type The edge weight type (input)
+ * 
+ * @return The name of the edge weight type
+ */
+const char *edge_weight_type_name(const EdgeWeightType type);
+
+/**
+ * Return the name of a cost matrix layout.
+ * 
+ * @param layout The layout (input)
+ * 
+ * @return The name of the layout, as given with -layout
+ */
+const char *cost_layout_name(const CostLayout layout);
+
+/**
+ * Read the name of a cost matrix layout.
+ * 
+ * @param name The name, as given with -layout (input)
+ * @param layout The layout (output)
+ * 
+ * @return True if the name is a layout, false otherwise
+ */
+bool parse_cost_layout(const char *name, CostLayout *layout);
+
 /**
  * Allocate the memory for the most space-consuming attributes of instance. 
  * NOTE: This function also initialize the solution.
+ * NOTE: If the cost matrix exceeds the memory budget, or cannot be allocated, the costs are left NULL 
+ *       and computed on the fly from the coordinates (matrix-free mode).
  * 
  * @param inst The instance to allocate (input/output)
  */
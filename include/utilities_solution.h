@@ -6,6 +6,8 @@
 #include "heuristics.h"
 #include "vns.h"
 #include "tabu_search.h"
+#include "lin_kernighan.h"
+#include "held_karp.h"
 #include "tsp_cplex.h"
 #include "benders.h"
 #include "branch_and_cut.h"
@@ -55,6 +57,7 @@ bool validate_node_visits(const instance *inst, const solution *sol);
 /**
  * Compute the total cost of the given solution path.
  * NOTE: This function assumes that the solution is a valid tour.
+ * NOTE: If the edge costs are cached, this is their sum (see validate_edge_costs()).
  * 
  * @param inst The instance that contains the problem data (input)
  * @param sol The solution of which to compute the cost (input)
@@ -63,6 +66,34 @@ bool validate_node_visits(const instance *inst, const solution *sol);
  */
 double compute_solution_cost(const instance *inst, const solution *sol);
 
+/**
+ * Cache the costs of the edges of the solution, so that the moves read the removed edges sequentially.
+ * The cache is allocated if needed and filled from the current tour: call it again after the tour is
+ * rewritten by anything else than the moves that maintain it (apply_two_opt_move(), apply_kopt_move()).
+ * 
+ * @param inst The instance that contains the problem data (input)
+ * @param sol The solution whose edge costs to cache (input/output)
+ */
+void cache_edge_costs(const instance *inst, solution *sol);
+
+/**
+ * Recompute the cost of the solution after its tour was rewritten, together with its cached edge costs if any.
+ * 
+ * @param inst The instance that contains the problem data (input)
+ * @param sol The solution to update (input/output)
+ */
+void recompute_solution_cost(const instance *inst, solution *sol);
+
+/**
+ * Check if the cached edge costs of the solution are the ones of its tour.
+ * 
+ * @param inst The instance that contains the problem data (input)
+ * @param sol The solution whose edge costs to check (input)
+ * 
+ * @return true if valid or not cached, false otherwise
+ */
+bool validate_edge_costs(const instance *inst, const solution *sol);
+
 /**
  * Check if the cost in the solution is the expected one.
  * 
@@ -97,6 +128,7 @@ bool update_sol(const instance *inst, solution *sol1, const solution *sol2, cons
 /**
  * Copy the second solution into the first solution.
  * NOTE: This function assumes that the first solution not initialized nor allocated.
+ * NOTE: The edge costs are copied only if the second solution caches them.
  * 
  * @param sol1 The first solution to copy into (output)
  * @param sol2 The second solution to copy from (input)
@@ -106,6 +138,7 @@ void copy_sol(solution *sol1, const solution *sol2, const int nnodes);
 
 /**
  * Plot the solution using gnuplot.
+ * NOTE: Nothing is plotted if the instance has no coordinates.
  * 
  * @param inst The instance that contains the problem data (input)
  * @param sol The solution to plot (input)
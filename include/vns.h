@@ -22,47 +22,17 @@ void vns(const instance *inst, solution *sol, const double timelimit);
 
 /**
  * Algorithm to modify the solution to escape the current local optima.
+ * The kicks are k-opt moves applied in place (apply_kopt_move()):
+ * - k = 3: A -> C -> B -> D (reorder from A-B-C-D), the kopt_move with order = {2, 1}
+ * - k = 5: A -> D -> !B -> E -> !C -> F (reorder from A-B-C-D-E-F), where !X denotes that the segment X is reversed
  *  
  * @param inst The instance that contains the problem data (input)
  * @param sol The solution to modify (input/output)
  * @param k The type of kick (input)
  * @param reps The number of k-opt moves that are performed as kick (input)
+ * @param scratch A buffer of at least nnodes entries for the moves, reused between the kicks (input/output)
  */
-void kick(const instance *inst, solution *sol, const int k, const int reps);
-
-/**
- * Rearrange tour segments in the solution following this pattern:
- * A -> D -> !B -> E -> !C -> F (reorder from A-B-C-D-E-F to A-D-!B-E-!C-F)
- * NOTE: !X denotes that the segment X is revesed.
- * NOTE: This function assumes 0 <= idx1 < idx2 < idx3 < idx4 < idx5 < nnodes.
- * 
- * @param sol The solution to modify (input/output)
- * @param nnodes The number of node of the instance (input)
- * @param idx1 The first index (input)
- * @param idx2 The second index (input)
- * @param idx3 The third index (input)
- * @param idx4 The fourth index (input)
- * @param idx5 The fifth index (input)
- */
-void fixed_five_opt_move(solution *sol, const int nnodes, int idx1, int idx2, int idx3, int idx4, int idx5);
-
-/**
- * Compute the delta cost after the 5-opt move: 
- * - remove edges (idx1, idx1+1), (idx2, idx2+1), (idx3, idx3+1), (idx4, idx4+1), (idx4, idx4+1)
- * - add edges (idx1, idx3+1), (idx4, idx2), (idx1+1, idx4+1), (idx5, idx3), (idx2+1, idx5+1)
- * NOTE: idx1, idx2, idx3, idx4 and idx5 are the index of nodes on solution.visited_nodes not the actual nodes.
- * 
- * @param inst The instance that contains the problem data (input)
- * @param sol The solution to modify (input/output)
- * @param idx1 The first index (input)
- * @param idx2 The second index (input)
- * @param idx3 The third index (input)
- * @param idx4 The fourth index (input)
- * @param idx5 The fifth index (input)
- * 
- * @return Cost of old edges minus cost of new edges
- */
-double delta5(const instance *inst, const solution *sol, const int idx1, const int idx2, const int idx3, const int idx4, const int idx5);
+void kick(const instance *inst, solution *sol, const int k, const int reps, int *scratch);
 
 /**
  * Select three random different indices in [0, n) and return them sorted.
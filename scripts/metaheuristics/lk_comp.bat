@@ -0,0 +1,51 @@
+@echo off
+setlocal enabledelayedexpansion
+
+REM Define constants
+set SEED_START=21
+set SEED_END=30
+set NODES=1000
+set TIMELIMIT=60
+
+REM Define specific parameter values (the options of each configuration are set below)
+set CONFIGS=TS VNS VNS_lk LK
+
+REM Empty the logs folder if it exists, otherwise create it
+if exist logs (
+    echo Emptying logs folder...
+    del /Q logs\*
+) else (
+    echo Creating logs folder...
+    mkdir logs
+)
+echo CONFIGS=%CONFIGS%
+
+REM Generate log files: the same seeds, so the same instances and starting tours, for all the configurations
+echo Executing...
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    for %%c in (%CONFIGS%) do (
+        if "%%c"=="TS" set "ARGS=-method TS"
+        if "%%c"=="VNS" set "ARGS=-method VNS"
+        if "%%c"=="VNS_lk" set "ARGS=-method VNS -ls lk"
+        if "%%c"=="LK" set "ARGS=-method LK"
+        echo Running with configuration=%%c, seed=%%s...
+        ..\..\build\Release\tsp.exe !ARGS! -n %NODES% -seed %%s -timelimit %TIMELIMIT% -verbose 0 > logs\%%c_n%NODES%_seed%%s.log
+    )
+)
+
+REM Create CSV header with parameter combinations
+echo 4,%CONFIGS: =,% > lk_comp.csv
+
+REM Extract data and populate CSV
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    set "line=%%s"
+    for %%c in (%CONFIGS%) do (
+        for /f "tokens=4 delims=;" %%a in ('findstr /C:"$STAT;" logs\%%c_n%NODES%_seed%%s.log') do (
+            set "cost=%%a"
+        )
+        set "line=!line!,!cost!"
+    )
+    echo !line! >> lk_comp.csv
+)
+
+echo All tasks completed! Lin-Kernighan comparison CSV successfully generated.
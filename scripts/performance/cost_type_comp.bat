@@ -0,0 +1,55 @@
+@echo off
+setlocal enabledelayedexpansion
+
+REM Define constants
+set SEED_START=1
+set SEED_END=10
+set INSTANCE=..\..\data\u1060.tsp
+set TIMELIMIT=600
+
+REM Define specific parameter values
+set COST_TYPE=double float int32
+
+REM Build one executable for each cost type
+for %%c in (%COST_TYPE%) do (
+    echo Building with TSP_COST_TYPE=%%c...
+    cmake -S ..\.. -B ..\..\build_%%c -DCMAKE_BUILD_TYPE=Release -DTSP_COST_TYPE=%%c > nul
+    cmake --build ..\..\build_%%c --config Release > nul
+)
+
+REM Empty the logs folder if it exists, otherwise create it
+if exist logs (
+    echo Emptying logs folder...
+    del /Q logs\*
+) else (
+    echo Creating logs folder...
+    mkdir logs
+)
+echo COST_TYPE=%COST_TYPE%
+
+REM Generate log files: NN + 2-opt runs until the local optimum, so the time measures the kernels
+echo Executing...
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    for %%c in (%COST_TYPE%) do (
+        echo Running with cost type=%%c, seed=%%s...
+        ..\..\build_%%c\Release\tsp.exe -file %INSTANCE% -method NN -seed %%s -timelimit %TIMELIMIT% -verbose 0 -param1 1 > logs\NN_u1060_seed%%s_%%c.log
+    )
+)
+
+REM Create CSV header with parameter combinations
+echo 3,double,float,int32 > cost_type.csv
+
+REM Extract data and populate CSV
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    set "line=%%s"
+    for %%c in (%COST_TYPE%) do (
+        for /f "tokens=5 delims=;" %%a in ('findstr /C:"$STAT;" logs\NN_u1060_seed%%s_%%c.log') do (
+            set "time=%%a"
+            if "!time:~-1!"==";" set "time=!time:~0,-1!"
+        )
+        set "line=!line!,!time!"
+    )
+    echo !line! >> cost_type.csv
+)
+
+echo All tasks completed! Cost type comparison CSV successfully generated.
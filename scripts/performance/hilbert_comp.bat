@@ -0,0 +1,50 @@
+@echo off
+setlocal enabledelayedexpansion
+
+REM Define constants
+set SEED_START=1
+set SEED_END=10
+set NODES=2000
+set TIMELIMIT=3600
+
+REM Define specific parameter values
+set HILBERT=0 1
+
+REM Empty the logs folder if it exists, otherwise create it
+if exist logs (
+    echo Emptying logs folder...
+    del /Q logs\*
+) else (
+    echo Creating logs folder...
+    mkdir logs
+)
+echo HILBERT=%HILBERT%
+
+REM Generate log files: NN + 2-opt runs until the local optimum, so the time measures the memory accesses of the scans
+REM NOTE: Cache misses are not visible from here: run the same command lines under a hardware profiler
+REM       (e.g. the memory access analysis of VTune or uProf) to count them
+echo Executing...
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    for %%h in (%HILBERT%) do (
+        echo Running with hilbert=%%h, seed=%%s...
+        ..\..\build\Release\tsp.exe -n %NODES% -method NN -seed %%s -timelimit %TIMELIMIT% -verbose 0 -param1 1 -hilbert %%h > logs\NN_n%NODES%_seed%%s_hilbert%%h.log
+    )
+)
+
+REM Create CSV header with parameter combinations
+echo 2,original,hilbert > hilbert.csv
+
+REM Extract data and populate CSV
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    set "line=%%s"
+    for %%h in (%HILBERT%) do (
+        for /f "tokens=5 delims=;" %%a in ('findstr /C:"$STAT;" logs\NN_n%NODES%_seed%%s_hilbert%%h.log') do (
+            set "time=%%a"
+            if "!time:~-1!"==";" set "time=!time:~0,-1!"
+        )
+        set "line=!line!,!time!"
+    )
+    echo !line! >> hilbert.csv
+)
+
+echo All tasks completed! Hilbert comparison CSV successfully generated.
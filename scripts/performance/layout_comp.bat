@@ -0,0 +1,61 @@
+@echo off
+setlocal enabledelayedexpansion
+
+REM Define constants
+set SEED=1
+set TIMELIMIT=3600
+set TS_TIMELIMIT=600
+
+REM Define specific parameter values
+set NODES=1000 2000 5000 10000
+set LAYOUTS=triangular full tiled
+
+REM Empty the logs folder if it exists, otherwise create it
+if exist logs (
+    echo Emptying logs folder...
+    del /Q logs\*
+) else (
+    echo Creating logs folder...
+    mkdir logs
+)
+REM The tabu search writes its statistics in the results folder
+if not exist results mkdir results
+echo NODES=%NODES%
+echo LAYOUTS=%LAYOUTS%
+
+REM Generate log files for the two scan-heavy kernels:
+REM - NN + 2-opt runs until the local optimum, so the time measures the scans of the 2-opt neighbourhood
+REM - TS runs for a fixed time (after its own 2-opt descent), the iterations per second measure the scans of move_to_best_neighbor()
+echo Executing...
+for %%n in (%NODES%) do (
+    for %%l in (%LAYOUTS%) do (
+        echo Running with n=%%n, layout=%%l...
+        ..\..\build\Release\tsp.exe -n %%n -method NN -seed %SEED% -timelimit %TIMELIMIT% -verbose 0 -param1 1 -layout %%l > logs\NN_n%%n_%%l.log
+        ..\..\build\Release\tsp.exe -n %%n -method TS -seed %SEED% -timelimit %TS_TIMELIMIT% -verbose 30 -param1 0 -layout %%l > logs\TS_n%%n_%%l.log
+    )
+)
+
+REM Create CSV headers with parameter combinations
+echo 3,%LAYOUTS: =,% > layout_2opt.csv
+echo 3,%LAYOUTS: =,% > layout_tabu.csv
+
+REM Extract data and populate CSV: one row for each size, 2-opt time and tabu iterations per second
+for %%n in (%NODES%) do (
+    set "line=%%n"
+    set "iters=%%n"
+    for %%l in (%LAYOUTS%) do (
+        for /f "tokens=5 delims=;" %%a in ('findstr /C:"$STAT;" logs\NN_n%%n_%%l.log') do (
+            set "time=%%a"
+            if "!time:~-1!"==";" set "time=!time:~0,-1!"
+        )
+        for /f "tokens=3 delims= " %%a in ('findstr /C:"Tabu search:" logs\TS_n%%n_%%l.log') do (
+            set "iter=%%a"
+        )
+        set "line=!line!,!time!"
+        set "iters=!iters!,!iter!"
+    )
+    echo !line! >> layout_2opt.csv
+    echo !iters! >> layout_tabu.csv
+)
+
+echo All tasks completed! Layout comparison CSVs successfully generated.
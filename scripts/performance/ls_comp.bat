@@ -0,0 +1,69 @@
+@echo off
+setlocal enabledelayedexpansion
+
+REM Define constants
+set SEED=1
+set INSTANCE=..\..\data\u1060.tsp
+
+REM Define specific parameter values (the options of each local search are set below)
+set TIMELIMITS=1 5 20 60
+set LOCAL_SEARCHES=2opt 2opt_nl 2opt_nl_oropt 3opt 3opt_oropt
+
+REM Empty the logs folder if it exists, otherwise create it
+if exist logs (
+    echo Emptying logs folder...
+    del /Q logs\*
+) else (
+    echo Creating logs folder...
+    mkdir logs
+)
+echo TIMELIMITS=%TIMELIMITS%
+echo LOCAL_SEARCHES=%LOCAL_SEARCHES%
+
+REM Generate log files: multi-start NN refined by each local search, the best tour found within each time limit
+REM NN from a single start gives the cost of the local optimum and the time to reach it
+echo Executing...
+for %%l in (%LOCAL_SEARCHES%) do (
+    if "%%l"=="2opt" set "LS_ARGS=-ls 2opt"
+    if "%%l"=="2opt_nl" set "LS_ARGS=-ls 2opt_nl"
+    if "%%l"=="2opt_nl_oropt" set "LS_ARGS=-ls 2opt_nl -oropt 1"
+    if "%%l"=="3opt" set "LS_ARGS=-ls 3opt"
+    if "%%l"=="3opt_oropt" set "LS_ARGS=-ls 3opt -oropt 1"
+    echo Running with local search=%%l...
+    ..\..\build\Release\tsp.exe -f %INSTANCE% -method NN -seed %SEED% -timelimit 3600 -verbose 0 -param1 1 !LS_ARGS! > logs\NN_%%l.log
+    for %%t in (%TIMELIMITS%) do (
+        ..\..\build\Release\tsp.exe -f %INSTANCE% -method MS_NN -seed %SEED% -timelimit %%t -verbose 0 -param1 1 !LS_ARGS! > logs\MS_NN_%%l_tl%%t.log
+    )
+)
+
+REM Create CSV headers with parameter combinations
+echo 5,%LOCAL_SEARCHES: =,% > ls_quality.csv
+echo 5,%LOCAL_SEARCHES: =,% > ls_single.csv
+
+REM Extract data and populate CSV: one row for each time limit with the best cost of each local search
+for %%t in (%TIMELIMITS%) do (
+    set "line=%%t"
+    for %%l in (%LOCAL_SEARCHES%) do (
+        for /f "tokens=4 delims=;" %%a in ('findstr /C:"$STAT;" logs\MS_NN_%%l_tl%%t.log') do (
+            set "cost=%%a"
+        )
+        set "line=!line!,!cost!"
+    )
+    echo !line! >> ls_quality.csv
+)
+
+REM Single start: a row with the cost of the local optimum, a row with the time to reach it
+set "costs=cost"
+set "times=time"
+for %%l in (%LOCAL_SEARCHES%) do (
+    for /f "tokens=4,5 delims=;" %%a in ('findstr /C:"$STAT;" logs\NN_%%l.log') do (
+        set "cost=%%a"
+        set "time=%%b"
+    )
+    set "costs=!costs!,!cost!"
+    set "times=!times!,!time!"
+)
+echo !costs! >> ls_single.csv
+echo !times! >> ls_single.csv
+
+echo All tasks completed! Local search comparison CSVs successfully generated.
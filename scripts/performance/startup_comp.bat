@@ -0,0 +1,57 @@
+@echo off
+setlocal enabledelayedexpansion
+
+REM Define constants
+set SEED_START=1
+set SEED_END=5
+set TIMELIMIT=600
+
+REM Define specific parameter values
+set NODES=10000 15000 20000
+
+REM Build the scalar baseline and the vectorized executable
+echo Building with TSP_SIMD=none...
+cmake -S ..\.. -B ..\..\build_scalar -DCMAKE_BUILD_TYPE=Release -DTSP_SIMD=none > nul
+cmake --build ..\..\build_scalar --config Release > nul
+echo Building with TSP_SIMD=avx2...
+cmake -S ..\.. -B ..\..\build_avx2 -DCMAKE_BUILD_TYPE=Release -DTSP_SIMD=avx2 > nul
+cmake --build ..\..\build_avx2 --config Release > nul
+
+REM Empty the logs folder if it exists, otherwise create it
+if exist logs (
+    echo Emptying logs folder...
+    del /Q logs\*
+) else (
+    echo Creating logs folder...
+    mkdir logs
+)
+echo NODES=%NODES%
+
+REM Generate log files: the time to compute the costs is printed at verbose 30, before solving with NN
+echo Executing...
+for %%n in (%NODES%) do (
+    for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+        echo Running with n=%%n, seed=%%s...
+        ..\..\build_scalar\Release\tsp.exe -n %%n -method NN -seed %%s -timelimit %TIMELIMIT% -verbose 30 -threads 1 > logs\startup_n%%n_seed%%s_scalar.log
+        ..\..\build_avx2\Release\tsp.exe -n %%n -method NN -seed %%s -timelimit %TIMELIMIT% -verbose 30 > logs\startup_n%%n_seed%%s_avx2.log
+    )
+)
+
+REM Create CSV header with parameter combinations
+echo 2,scalar_1thread,avx2_threads > startup.csv
+
+REM Extract data and populate CSV: "Costs computed in <time> seconds ..."
+for %%n in (%NODES%) do (
+    for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+        set "line=n%%n_s%%s"
+        for %%b in (scalar avx2) do (
+            for /f "tokens=4" %%a in ('findstr /C:"Costs computed" logs\startup_n%%n_seed%%s_%%b.log') do (
+                set "time=%%a"
+            )
+            set "line=!line!,!time!"
+        )
+        echo !line! >> startup.csv
+    )
+)
+
+echo All tasks completed! Startup comparison CSV successfully generated.
@@ -0,0 +1,68 @@
+@echo off
+setlocal enabledelayedexpansion
+
+REM Define constants
+set SEED_START=1
+set SEED_END=5
+set NNODES=200000
+set TIMELIMIT=3600
+
+REM Define specific parameter values: the full 2-opt and the sequential 2-opt over the candidate lists as baselines,
+REM then the parallel one with more threads, also with Or-opt in the sub-paths
+REM NOTE: Each move of the full 2-opt scans all the pairs of edges (O(n^2)): on 100000+ nodes it does not reach the
+REM       local optimum, so it runs for FULL_TIMELIMIT and its cost shows how far it got
+set FULL_TIMELIMIT=600
+set CONFIGURATIONS=2opt 2opt_nl par2 par4 par8 par16 par32 nl_oropt par4_oropt par16_oropt
+
+REM Empty the logs folder if it exists, otherwise create it
+if exist logs (
+    echo Emptying logs folder...
+    del /Q logs\*
+) else (
+    echo Creating logs folder...
+    mkdir logs
+)
+echo NNODES=%NNODES%
+echo CONFIGURATIONS=%CONFIGURATIONS%
+
+REM Generate log files: NN + 2-opt runs until the local optimum on random uniform instances
+echo Executing...
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    for %%c in (%CONFIGURATIONS%) do (
+        if "%%c"=="2opt" set "ARGS=-ls 2opt -timelimit %FULL_TIMELIMIT%"
+        if "%%c"=="2opt_nl" set "ARGS=-ls 2opt_nl"
+        if "%%c"=="par2" set "ARGS=-ls 2opt_par -threads 2"
+        if "%%c"=="par4" set "ARGS=-ls 2opt_par -threads 4"
+        if "%%c"=="par8" set "ARGS=-ls 2opt_par -threads 8"
+        if "%%c"=="par16" set "ARGS=-ls 2opt_par -threads 16"
+        if "%%c"=="par32" set "ARGS=-ls 2opt_par -threads 32"
+        if "%%c"=="nl_oropt" set "ARGS=-ls 2opt_nl,oropt"
+        if "%%c"=="par4_oropt" set "ARGS=-ls 2opt_par,oropt -threads 4"
+        if "%%c"=="par16_oropt" set "ARGS=-ls 2opt_par,oropt -threads 16"
+        echo Running with configuration=%%c, seed=%%s...
+        ..\..\build\Release\tsp.exe -n %NNODES% -gen uniform -method NN -seed %%s -timelimit %TIMELIMIT% -verbose 30 -param1 1 !ARGS! > logs\NN_%%c_seed%%s.log
+    )
+)
+
+REM Create CSV headers with parameter combinations
+echo 10,%CONFIGURATIONS: =,% > two_opt_par_time.csv
+echo 10,%CONFIGURATIONS: =,% > two_opt_par_cost.csv
+
+REM Extract data and populate CSV: one row for each seed with the time and the cost of each configuration
+REM NOTE: The time includes NN, the same for all the configurations
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    set "times=%%s"
+    set "costs=%%s"
+    for %%c in (%CONFIGURATIONS%) do (
+        for /f "tokens=4,5 delims=;" %%a in ('findstr /C:"$STAT;" logs\NN_%%c_seed%%s.log') do (
+            set "cost=%%a"
+            set "time=%%b"
+        )
+        set "times=!times!,!time!"
+        set "costs=!costs!,!cost!"
+    )
+    echo !times! >> two_opt_par_time.csv
+    echo !costs! >> two_opt_par_cost.csv
+)
+
+echo All tasks completed! Parallel 2-opt comparison CSVs successfully generated.
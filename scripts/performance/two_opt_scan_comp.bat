@@ -0,0 +1,54 @@
+@echo off
+setlocal enabledelayedexpansion
+
+REM Define constants
+set SEED_START=1
+set SEED_END=10
+set INSTANCE=..\..\data\u1060.tsp
+set TIMELIMIT=600
+
+REM Define specific parameter values: none is the scalar scan, with delta2() for each move
+set SIMD=avx2 sse2 none
+
+REM Build one executable for each instruction set
+for %%c in (%SIMD%) do (
+    echo Building with TSP_SIMD=%%c...
+    cmake -S ..\.. -B ..\..\build_%%c -DCMAKE_BUILD_TYPE=Release -DTSP_SIMD=%%c > nul
+    cmake --build ..\..\build_%%c --config Release > nul
+)
+
+REM Empty the logs folder if it exists, otherwise create it
+if exist logs (
+    echo Emptying logs folder...
+    del /Q logs\*
+) else (
+    echo Creating logs folder...
+    mkdir logs
+)
+echo SIMD=%SIMD%
+
+REM Generate log files: NN + 2-opt runs until the local optimum, the 2-opt prints the moves evaluated per second
+echo Executing...
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    for %%c in (%SIMD%) do (
+        echo Running with TSP_SIMD=%%c, seed=%%s...
+        ..\..\build_%%c\Release\tsp.exe -file %INSTANCE% -method NN -seed %%s -timelimit %TIMELIMIT% -verbose 30 -param1 1 > logs\NN_u1060_seed%%s_%%c.log
+    )
+)
+
+REM Create CSV header with parameter combinations
+echo 3,avx2,sse2,none > two_opt_scan.csv
+
+REM Extract data and populate CSV: moves evaluated per second
+for /l %%s in (%SEED_START%,1,%SEED_END%) do (
+    set "line=%%s"
+    for %%c in (%SIMD%) do (
+        for /f "tokens=2 delims= " %%a in ('findstr /C:"2-opt:" logs\NN_u1060_seed%%s_%%c.log') do (
+            set "rate=%%a"
+        )
+        set "line=!line!,!rate!"
+    )
+    echo !line! >> two_opt_scan.csv
+)
+
+echo All tasks completed! 2-opt scan comparison CSV successfully generated.
@@ -291,7 +291,7 @@ void patch_heuristic(const instance *inst, solution *sol, int *succ, int *comp,
     build_solution_from_CPLEX(inst, sol, succ);
 
     // Improve the solution using 2-opt refinement
-    two_opt(inst, sol, timelimit - get_elapsed_time(t_start), false);
+    local_search(inst, sol, timelimit - get_elapsed_time(t_start), false);
 
 }
 
@@ -0,0 +1,67 @@
+#include "distances.h"
+
+#if defined(SIMD_AVX2) || defined(SIMD_SSE2)
+
+// Fill a block of distances with the given vector kernel, the remainder with the scalar one
+#define DISTANCE_ROW_SIMD(vkernel, kernel)                                                                  \
+    {                                                                                                       \
+        vdouble vx = vset1(x);                                                                              \
+        vdouble vy = vset1(y);                                                                              \
+        int k = 0;                                                                                          \
+        for (; k + VWIDTH <= count; k += VWIDTH) {                                                          \
+            vstore_costs(&out[k], vkernel(vx, vy, vloadu(&xs[k]), vloadu(&ys[k])));                         \
+        }                                                                                                   \
+        for (; k < count; k++) {                                                                            \
+            out[k] = to_cost(kernel(x, y, xs[k], ys[k]));                                                   \
+        }                                                                                                   \
+    }
+
+#endif
+
+// Fill a block of distances with the given kernel
+// NOTE: The loop reads contiguous coordinates and has no dependencies between iterations, so the compiler can vectorize it
+#define DISTANCE_ROW(kernel)                                                                                \
+    for (int k = 0; k < count; k++) {                                                                       \
+        out[k] = to_cost(kernel(x, y, xs[k], ys[k]));                                                       \
+    }
+
+// Return the distance kernel of an edge weight type
+distance_fn distance_kernel(const EdgeWeightType type) {
+
+    switch (type) {
+
+        case EUC_2D:    return euc_2d_dist;
+        case CEIL_2D:   return ceil_2d_dist;
+        case ATT:       return att_dist;
+        case GEO:       return geo_dist;
+        default:        return dist;
+
+    }
+
+}
+
+// Compute the distances from a point to a block of points
+void distance_row(const instance *inst, const double x, const double y, const double *xs, const double *ys, const int count, cost_t *out) {
+
+    // Select the kernel only once: each loop is specialized on its own inlined kernel
+    switch (inst->edge_weight_type) {
+
+#if defined(SIMD_AVX2) || defined(SIMD_SSE2)
+        case EUC_2D:    DISTANCE_ROW_SIMD(veuc_2d_dist, euc_2d_dist);   break;
+        case CEIL_2D:   DISTANCE_ROW_SIMD(vceil_2d_dist, ceil_2d_dist); break;
+        case ATT:       DISTANCE_ROW_SIMD(vatt_dist, att_dist);         break;
+        case GEO:       DISTANCE_ROW(geo_dist);                         break;
+        default:
+        case EUCLIDEAN: DISTANCE_ROW_SIMD(vdist, dist);                 break;
+#else
+        case EUC_2D:    DISTANCE_ROW(euc_2d_dist);  break;
+        case CEIL_2D:   DISTANCE_ROW(ceil_2d_dist); break;
+        case ATT:       DISTANCE_ROW(att_dist);     break;
+        case GEO:       DISTANCE_ROW(geo_dist);     break;
+        default:
+        case EUCLIDEAN: DISTANCE_ROW(dist);         break;
+#endif
+
+    }
+
+}
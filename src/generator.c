@@ -0,0 +1,190 @@
+#include "generator.h"
+
+// Generate a random instance of the family asked
+void generate_instance(instance *inst) {
+
+    double t_start = get_time_in_milliseconds();
+
+    // Integer coordinates: the costs are the ones of the TSPLIB file written with -out
+    inst->edge_weight_type = EUC_2D;
+    allocate_instance(inst);
+
+    if (inst->verbose >= GOOD) {
+
+        printf("Creating random instance (%s family):\n\n", generator_family_name(inst->generator));
+
+    }
+
+    // Each thread generates a contiguous range of nodes
+    int nthreads = get_number_of_threads(inst);
+    if (nthreads > inst->nnodes) nthreads = inst->nnodes;
+    if (nthreads < 1) nthreads = 1;
+
+    generator_worker_data *data = (generator_worker_data *) malloc(nthreads * sizeof(generator_worker_data));
+    HANDLE *threads = (HANDLE *) malloc(nthreads * sizeof(HANDLE));
+
+    if (data == NULL || threads == NULL) print_error("generate_instance(): Cannot allocate memory");
+
+    for (int t = 0; t < nthreads; t++) {
+
+        data[t].inst = inst;
+        data[t].first = (int) ((long long) inst->nnodes * t / nthreads);
+        data[t].last = (int) ((long long) inst->nnodes * (t + 1) / nthreads);
+
+    }
+
+    if (nthreads == 1) {
+
+        generator_worker(&data[0]);
+
+    } else {
+
+        for (int t = 0; t < nthreads; t++) {
+
+            threads[t] = CreateThread(NULL, 0, generator_worker, &data[t], 0, NULL);
+            if (threads[t] == NULL) print_error("generate_instance(): Cannot create thread");
+
+        }
+
+        WaitForMultipleObjects(nthreads, threads, TRUE, INFINITE);
+
+        for (int t = 0; t < nthreads; t++) CloseHandle(threads[t]);
+
+    }
+
+    free(threads);
+    free(data);
+
+    // If asked, print the coordinates
+    if (inst->verbose >= DEBUG_V) {
+
+        for (int i = 0; i < inst->nnodes; i++) {
+
+            printf("Node %5d, x %10.0lf, y %10.0lf\n", i, inst->coord[i].x, inst->coord[i].y);
+
+        }
+
+        printf("\n\n");
+
+    }
+
+    if (inst->verbose >= LOW) {
+
+        printf("Generated %d nodes in %lf seconds (%s family, %d threads)\n", inst->nnodes, get_elapsed_time(t_start), generator_family_name(inst->generator), nthreads);
+
+    }
+
+}
+
+// Generate the nodes in [first, last) of the instance
+DWORD WINAPI generator_worker(LPVOID param) {
+
+    generator_worker_data *data = (generator_worker_data *) param;
+    instance *inst = data->inst;
+
+    unsigned long long key = stream_key(inst->seed, GEN_STREAM_NODES);
+    unsigned long long centers_key = stream_key(inst->seed, GEN_STREAM_CENTERS);
+
+    // Clusters: n/GEN_CLUSTER_NODES uniform centers, standard deviation GEN_SIDE/sqrt(n) as in the DIMACS generator
+    int nclusters = inst->nnodes / GEN_CLUSTER_NODES;
+    if (nclusters < 1) nclusters = 1;
+    double sigma = GEN_SIDE / sqrt((double) inst->nnodes);
+
+    // Grid: the smallest square grid with at least n cells, filled by rows
+    int grid_side = (int) ceil(sqrt((double) inst->nnodes));
+    double step = GEN_SIDE / grid_side;
+
+    for (int i = data->first; i < data->last; i++) {
+
+        // The draws of node i are the numbers i*GEN_DRAWS, ..., i*GEN_DRAWS+GEN_DRAWS-1 of its stream
+        unsigned long long counter = (unsigned long long) i * GEN_DRAWS;
+        double u0 = counter_random01(key, counter);
+        double u1 = counter_random01(key, counter + 1);
+
+        double x, y;
+
+        switch (inst->generator) {
+
+            case GEN_CLUSTER: {
+
+                // Center of a random cluster, recomputed from its own draws
+                int c = (int) (u0 * nclusters);
+                double cx = floor(counter_random01(centers_key, 2ULL * c) * GEN_SIDE);
+                double cy = floor(counter_random01(centers_key, 2ULL * c + 1) * GEN_SIDE);
+
+                // Gaussian shift (Box-Muller), 1-u is in (0, 1]
+                double radius = sigma * sqrt(-2.0 * log(1.0 - counter_random01(key, counter + 2)));
+                double angle = GEN_TWO_PI * u1;
+
+                x = cx + radius * cos(angle);
+                y = cy + radius * sin(angle);
+                break;
+
+            }
+
+            case GEN_GRID: {
+
+                x = ((i % grid_side) + 0.5 + (u0 - 0.5) * GEN_GRID_PERTURBATION * 2.0) * step;
+                y = ((i / grid_side) + 0.5 + (u1 - 0.5) * GEN_GRID_PERTURBATION * 2.0) * step;
+                break;
+
+            }
+
+            default:
+            case GEN_UNIFORM: {
+
+                x = u0 * GEN_SIDE;
+                y = u1 * GEN_SIDE;
+                break;
+
+            }
+
+        }
+
+        // Integer coordinates inside the square
+        x = floor(x);
+        y = floor(y);
+
+        inst->coord[i].x = (x < 0.0) ? 0.0 : (x > GEN_SIDE - 1.0) ? GEN_SIDE - 1.0 : x;
+        inst->coord[i].y = (y < 0.0) ? 0.0 : (y > GEN_SIDE - 1.0) ? GEN_SIDE - 1.0 : y;
+
+    }
+
+    return 0;
+
+}
+
+// Return the name of a family of random instances
+const char *generator_family_name(const GeneratorFamily family) {
+
+    switch (family) {
+
+        case GEN_UNIFORM:   return "uniform";
+        case GEN_CLUSTER:   return "cluster";
+        case GEN_GRID:      return "grid";
+        default:
+        case GEN_RAND:      return "rand";
+
+    }
+
+}
+
+// Read the name of a family of random instances
+bool parse_generator_family(const char *name, GeneratorFamily *family) {
+
+    const GeneratorFamily families[] = {GEN_RAND, GEN_UNIFORM, GEN_CLUSTER, GEN_GRID};
+
+    for (int f = 0; f < (int) (sizeof(families) / sizeof(families[0])); f++) {
+
+        if (strcmp(name, generator_family_name(families[f])) == 0) {
+
+            *family = families[f];
+            return true;
+
+        }
+
+    }
+
+    return false;
+
+}
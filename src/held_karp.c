@@ -0,0 +1,258 @@
+#include "held_karp.h"
+
+// Allocate the tables of the Held-Karp dynamic programming
+void held_karp_init(held_karp *hk, const int max_inner) {
+
+    size_t states = ((size_t) 1 << max_inner) * max_inner;
+
+    hk->max_inner = max_inner;
+    hk->table = (double *) malloc(states * sizeof(double));
+    hk->parent = (unsigned char *) malloc(states * sizeof(unsigned char));
+    hk->dist = (double *) malloc(((size_t) max_inner * max_inner + 2 * max_inner) * sizeof(double));
+
+    if (hk->table == NULL || hk->parent == NULL || hk->dist == NULL) print_error("held_karp_init(): Cannot allocate memory");
+
+}
+
+// Free the tables of the Held-Karp dynamic programming
+void held_karp_free(held_karp *hk) {
+
+    free(hk->table);
+    free(hk->parent);
+    free(hk->dist);
+
+    hk->table = NULL;
+    hk->parent = NULL;
+    hk->dist = NULL;
+
+}
+
+// Find the best Hamiltonian path from start to end through the inner nodes
+double held_karp_path(held_karp *hk, const instance *inst, const int start, const int end, const int *inner, const int m, int *order) {
+
+    if (m == 0) return cost(start, end, inst);
+
+    // The costs are read once from the matrix
+    double *dist = hk->dist;
+    double *from_start = &hk->dist[m * m];
+    double *to_end = &hk->dist[m * m + m];
+
+    for (int j = 0; j < m; j++) {
+
+        for (int k = 0; k < m; k++) dist[j * m + k] = cost(inner[j], inner[k], inst);
+
+        from_start[j] = cost(start, inner[j], inst);
+        to_end[j] = cost(inner[j], end, inst);
+
+    }
+
+    double *table = hk->table;
+    unsigned char *parent = hk->parent;
+    int full = (1 << m) - 1;
+
+    // Each state is computed from the states of the subset without its last node, which are smaller masks
+    for (int mask = 1; mask <= full; mask++) {
+
+        for (int j = 0; j < m; j++) {
+
+            if (!(mask & (1 << j))) continue;
+
+            int prev_mask = mask ^ (1 << j);
+            size_t state = (size_t) mask * m + j;
+
+            if (prev_mask == 0) {
+
+                table[state] = from_start[j];
+                parent[state] = (unsigned char) j;
+                continue;
+
+            }
+
+            double best = INFINITY;
+            int best_k = -1;
+
+            for (int k = 0; k < m; k++) {
+
+                if (!(prev_mask & (1 << k))) continue;
+
+                double value = table[(size_t) prev_mask * m + k] + dist[k * m + j];
+
+                if (value < best) {
+
+                    best = value;
+                    best_k = k;
+
+                }
+
+            }
+
+            table[state] = best;
+            parent[state] = (unsigned char) best_k;
+
+        }
+
+    }
+
+    // Close the path at end
+    double best = INFINITY;
+    int last = -1;
+
+    for (int j = 0; j < m; j++) {
+
+        double value = table[(size_t) full * m + j] + to_end[j];
+
+        if (value < best) {
+
+            best = value;
+            last = j;
+
+        }
+
+    }
+
+    // Walk the parents back from the last inner node
+    int mask = full;
+
+    for (int pos = m - 1; pos >= 0; pos--) {
+
+        order[pos] = inner[last];
+
+        int prev = parent[(size_t) mask * m + last];
+        mask ^= (1 << last);
+        last = prev;
+
+    }
+
+    return best;
+
+}
+
+// Solve the instance exactly with the Held-Karp dynamic programming
+void held_karp_tour(const instance *inst, solution *sol) {
+
+    double t_start = get_time_in_milliseconds();
+    int n = inst->nnodes;
+
+    if (n > DP_EXACT_MAX_NODES) print_error("held_karp_tour(): Too many nodes for the dynamic programming");
+
+    // The tour is the best path from node 0 back to node 0 through all the other nodes
+    held_karp hk;
+    held_karp_init(&hk, n - 1);
+
+    int inner[DP_EXACT_MAX_NODES];
+    for (int i = 1; i < n; i++) inner[i - 1] = i;
+
+    sol->visited_nodes[0] = 0;
+    held_karp_path(&hk, inst, 0, 0, inner, n - 1, &sol->visited_nodes[1]);
+    sol->visited_nodes[n] = 0;
+
+    held_karp_free(&hk);
+
+    recompute_solution_cost(inst, sol);
+    strncpy_s(sol->method, METH_NAME_LEN, HELD_KARP, _TRUNCATE);
+
+    if (inst->verbose >= LOW) {
+
+        printf("Held-Karp: optimal tour of %d nodes in %lf seconds\n", n, get_elapsed_time(t_start));
+
+    }
+
+    if (inst->verbose >= GOOD) {
+
+        check_sol(inst, sol);
+
+    }
+
+}
+
+// Re-optimize the tour by windows with the Held-Karp dynamic programming
+void dp_window(const instance *inst, solution *sol, const double timelimit, bool print) {
+
+    int n = inst->nnodes;
+    int w = (inst->dp_window > 0) ? inst->dp_window : DP_DEFAULT_WINDOW;
+    if (w > n) w = n;
+
+    if (w < 4) return;
+
+    double t_start = get_time_in_milliseconds();
+    double old_cost = sol->cost;
+    int moves = 0;
+
+    int m = w - 2;
+    int inner[DP_MAX_WINDOW];
+    int order[DP_MAX_WINDOW];
+    int *nodes = sol->visited_nodes;
+
+    held_karp hk;
+    held_karp_init(&hk, m);
+
+    bool improved = true;
+
+    while (improved && get_elapsed_time(t_start) < timelimit) {
+
+        improved = false;
+
+        // Window from position p to position p+w-1, around the closing edge of the tour
+        for (int p = 0; p < n; p++) {
+
+            if (get_elapsed_time(t_start) >= timelimit) break;
+
+            int start = nodes[p];
+            int end = nodes[(p + w - 1) % n];
+
+            double path_cost = 0.0;
+
+            for (int k = 0; k < w - 1; k++) {
+
+                int pos = (p + k) % n;
+                path_cost += (sol->edge_cost != NULL) ? sol->edge_cost[pos] : cost(nodes[pos], nodes[pos + 1], inst);
+
+            }
+
+            for (int k = 0; k < m; k++) inner[k] = nodes[(p + 1 + k) % n];
+
+            double best = held_karp_path(&hk, inst, start, end, inner, m, order);
+
+            if (best >= path_cost - EPSILON) continue;
+
+            // Put the inner nodes in their new order, in place
+            for (int k = 0; k < m; k++) nodes[(p + 1 + k) % n] = order[k];
+            nodes[n] = nodes[0];
+
+            if (sol->edge_cost != NULL) {
+
+                for (int k = 0; k < w - 1; k++) {
+
+                    int pos = (p + k) % n;
+                    sol->edge_cost[pos] = cost(nodes[pos], nodes[pos + 1], inst);
+
+                }
+
+            }
+
+            sol->cost += best - path_cost;
+            moves++;
+            improved = true;
+
+        }
+
+    }
+
+    held_karp_free(&hk);
+
+    // The deltas accumulate rounding errors: the cost is the one of the final tour
+    if (moves > 0) recompute_solution_cost(inst, sol);
+
+    if (print && moves > 0 && inst->verbose >= ONLY_INCUMBENT) {
+
+        printf(" * DP windows: Old cost %10.6lf, New cost %10.6lf, Moves %d, Time %10.6lf\n", old_cost, sol->cost, moves, get_elapsed_time(t_start));
+
+    }
+
+    if (inst->verbose >= GOOD) {
+
+        check_sol(inst, sol);
+
+    }
+
+}
@@ -26,6 +26,30 @@ int find_nearest_node(const instance *inst, const int len, const int *visited_no
 
 }
 
+// Find the next nearest node from coordinates in tour order
+int find_nearest_point(const instance *inst, const int len, const double *xs, const double *ys, cost_t *buffer) {
+
+    int count = inst->nnodes - len;
+    distance_row(inst, xs[len - 1], ys[len - 1], &xs[len], &ys[len], count, buffer);
+
+    int nearest = -1;
+    double min_cost = INFINITY;
+
+    for (int i = 0; i < count; i++) {
+
+        if (buffer[i] < min_cost) {
+
+            min_cost = buffer[i];
+            nearest = len + i;
+
+        }
+
+    }
+
+    return nearest;
+
+}
+
 // Swap two nodes in the array
 void swap_nodes(int *nodes, const int i, const int j) {
 
@@ -48,67 +72,36 @@ void reverse_segment(solution *sol, const int i, const int j) {
 
 }
 
-// Reorder tour segments from A -> B -> C to A -> C -> B
-void shift_segment(solution *sol, const int n, const int idx1, const int idx2, const int idx3) {
-    
-    // Calculate segment sizes
-    int segment1_size = (idx2+1) - (idx1+1);
-    int segment2_size = (idx3+1) - (idx2+1);
-    int segment3_size = n - (idx3+1) + (idx1+1);
-    
-    // Allocate memory for segments
-    int *segment1 = (int *)malloc(segment1_size * sizeof(int));
-    int *segment2 = (int *)malloc(segment2_size * sizeof(int));
-    int *segment3 = (int *)malloc(segment3_size * sizeof(int));
+// Apply the 2-opt move (i, j) keeping the cached edge costs up to date
+void apply_two_opt_move(const instance *inst, solution *sol, const int i, const int j) {
+
+    reverse_segment(sol, i, j);
+
+    if (sol->edge_cost == NULL) return;
+
+    // The edges inside the segment are traversed backwards: edge i+k becomes edge j-1-k
+    double *edge = sol->edge_cost;
+
+    for (int k = 0; k < (j - i) / 2; k++) {
+
+        double temp = edge[i + k];
+        edge[i + k] = edge[j - 1 - k];
+        edge[j - 1 - k] = temp;
 
-    if (segment1 == NULL || segment2 == NULL || segment3 == NULL) print_error("shift_segment(): Cannot allocate memory");
-    
-    // Copy segments
-    for (int j = 0; j < segment1_size; j++) {
-        segment1[j] = sol->visited_nodes[(idx1+1+j) % n];
-    }
-    
-    for (int j = 0; j < segment2_size; j++) {
-        segment2[j] = sol->visited_nodes[(idx2+1+j) % n];
-    }
-    
-    for (int j = 0; j < segment3_size; j++) {
-        segment3[j] = sol->visited_nodes[(idx3+1+j) % n];
-    }
-    
-    // Rearrange segments
-    int pos = (idx1+1) % n;
-    
-    // Place segment2
-    for (int j = 0; j < segment2_size; j++) {
-        sol->visited_nodes[pos] = segment2[j];
-        pos = (pos + 1) % n;
-    }
-    
-    // Place segment1
-    for (int j = 0; j < segment1_size; j++) {
-        sol->visited_nodes[pos] = segment1[j];
-        pos = (pos + 1) % n;
-    }
-    
-    // Place segment3
-    for (int j = 0; j < segment3_size; j++) {
-        sol->visited_nodes[pos] = segment3[j];
-        pos = (pos + 1) % n;
     }
-    
-    // Free allocated memory
-    free(segment1);
-    free(segment2);
-    free(segment3);    
+
+    edge[i - 1] = cost(sol->visited_nodes[i - 1], sol->visited_nodes[i], inst);
+    edge[j] = cost(sol->visited_nodes[j], sol->visited_nodes[j + 1], inst);
 
 }
 
 // Compute the delta cost after the 2-opt move
 double delta2(const instance *inst, const solution *sol, const int i, const int j) {
     
-    // Compute the cost of the two edges that would be removed
-    double old_cost = cost(sol->visited_nodes[i-1], sol->visited_nodes[i], inst) +
+    // Compute the cost of the two edges that would be removed, from the cache if any
+    const double *edge = sol->edge_cost;
+    double old_cost = (edge != NULL) ? edge[i-1] + edge[j] :
+                      cost(sol->visited_nodes[i-1], sol->visited_nodes[i], inst) +
                       cost(sol->visited_nodes[j], sol->visited_nodes[j+1], inst);
 
     // Compute the cost of the two new edges that would be added
@@ -119,11 +112,163 @@ double delta2(const instance *inst, const solution *sol, const int i, const int
 
 }
 
+// Allocate the working memory of the 2-opt scan
+void two_opt_scan_init(two_opt_scan *scan, const instance *inst) {
+
+    int n = inst->nnodes;
+
+    // GEO has no vector kernel and EXPLICIT no coordinates: their costs are gathered with delta2()
+#if defined(SIMD_AVX2) || defined(SIMD_SSE2)
+    scan->vectorized = (inst->x != NULL && inst->edge_weight_type != GEO && inst->edge_weight_type != EXPLICIT);
+#else
+    scan->vectorized = false;
+#endif
+
+    scan->sol = NULL;
+    scan->x = NULL;
+    scan->y = NULL;
+    scan->edge = NULL;
+    scan->row_prev = NULL;
+    scan->row_next = NULL;
+    scan->moves = 0;
+
+    scan->delta = (double *) malloc(n * sizeof(double));
+    if (scan->delta == NULL) print_error("two_opt_scan_init(): Cannot allocate memory");
+
+    if (scan->vectorized) {
+
+        scan->x = (double *) malloc((n + 1) * sizeof(double));
+        scan->y = (double *) malloc((n + 1) * sizeof(double));
+        scan->edge = (double *) malloc(n * sizeof(double));
+        scan->row_prev = (cost_t *) malloc(n * sizeof(cost_t));
+        scan->row_next = (cost_t *) malloc(n * sizeof(cost_t));
+
+        if (scan->x == NULL || scan->y == NULL || scan->edge == NULL || scan->row_prev == NULL || scan->row_next == NULL) {
+
+            print_error("two_opt_scan_init(): Cannot allocate memory");
+
+        }
+
+    }
+
+}
+
+// Free the working memory of the 2-opt scan
+void two_opt_scan_free(two_opt_scan *scan) {
+
+    free(scan->x);
+    free(scan->y);
+    free(scan->edge);
+    free(scan->row_prev);
+    free(scan->row_next);
+    free(scan->delta);
+
+}
+
+// Load the tour of a solution in the 2-opt scan
+void two_opt_scan_load(two_opt_scan *scan, const instance *inst, const solution *sol) {
+
+    scan->sol = sol;
+
+    if (!scan->vectorized) return;
+
+    const int *tour = sol->visited_nodes;
+
+    for (int p = 0; p <= inst->nnodes; p++) {
+
+        scan->x[p] = inst->x[tour[p]];
+        scan->y[p] = inst->y[tour[p]];
+
+    }
+
+    if (sol->edge_cost != NULL) {
+
+        memcpy(scan->edge, sol->edge_cost, inst->nnodes * sizeof(double));
+        return;
+
+    }
+
+    for (int p = 0; p < inst->nnodes; p++) {
+
+        scan->edge[p] = cost(tour[p], tour[p+1], inst);
+
+    }
+
+}
+
+// Compute the deltas of the 2-opt moves (i, j) for j from first to last
+double *two_opt_scan_row(two_opt_scan *scan, const instance *inst, const int i, const int first, const int last) {
+
+    int count = last - first + 1;
+    double *delta = scan->delta;
+
+    scan->moves += count;
+
+    if (!scan->vectorized) {
+
+        for (int k = 0; k < count; k++) delta[k] = delta2(inst, scan->sol, i, first + k);
+        return delta;
+
+    }
+
+    // Added edges: (i-1, j) and (i, j+1), two contiguous rows of the tour-ordered coordinates
+    distance_row(inst, scan->x[i-1], scan->y[i-1], &scan->x[first], &scan->y[first], count, scan->row_prev);
+    distance_row(inst, scan->x[i], scan->y[i], &scan->x[first+1], &scan->y[first+1], count, scan->row_next);
+
+    // Removed edges: (i-1, i) and (j, j+1), summed in the same order of delta2()
+    const double removed = scan->edge[i-1];
+    const double *edge = &scan->edge[first];
+    const cost_t *row_prev = scan->row_prev;
+    const cost_t *row_next = scan->row_next;
+
+    for (int k = 0; k < count; k++) {
+
+        delta[k] = ((double) row_prev[k] + (double) row_next[k]) - (removed + edge[k]);
+
+    }
+
+    return delta;
+
+}
+
+// Find the minimum of an array of deltas
+double min_delta(const double *delta, const int count) {
+
+    double best = INFINITY;
+    int k = 0;
+
+#if defined(SIMD_AVX2) || defined(SIMD_SSE2)
+    vdouble vbest = vset1(INFINITY);
+
+    for (; k + VWIDTH <= count; k += VWIDTH) vbest = vmin(vbest, vloadu(&delta[k]));
+
+    double lanes[VWIDTH];
+    vstoreu(lanes, vbest);
+
+    for (int l = 0; l < VWIDTH; l++) {
+
+        if (lanes[l] < best) best = lanes[l];
+
+    }
+#endif
+
+    for (; k < count; k++) {
+
+        if (delta[k] < best) best = delta[k];
+
+    }
+
+    return best;
+
+}
+
 // Compute the delta cost after the 3-opt move
 double delta3(const instance *inst, const solution *sol, const int idx1, const int idx2, const int idx3) {
     
-    // Compute the cost of the three edges that would be removed
-    double old_cost = cost(sol->visited_nodes[idx1], sol->visited_nodes[idx1+1], inst) +
+    // Compute the cost of the three edges that would be removed, from the cache if any
+    const double *edge = sol->edge_cost;
+    double old_cost = (edge != NULL) ? edge[idx1] + edge[idx2] + edge[idx3] :
+                      cost(sol->visited_nodes[idx1], sol->visited_nodes[idx1+1], inst) +
                       cost(sol->visited_nodes[idx2], sol->visited_nodes[idx2+1], inst) +
                       cost(sol->visited_nodes[idx3], sol->visited_nodes[idx3+1], inst);
         
@@ -136,6 +281,80 @@ double delta3(const instance *inst, const solution *sol, const int idx1, const i
 
 }
 
+// Apply a k-opt move on the visited nodes of the solution
+void apply_kopt_move(const instance *inst, solution *sol, const kopt_move *move, int *scratch) {
+
+    int first = move->idx[0] + 1;
+    int last = move->idx[move->k - 1];
+
+    // The nodes out of [first, last] do not move
+    memcpy(scratch, &sol->visited_nodes[first], (last - first + 1) * sizeof(int));
+
+    int pos = first;
+
+    for (int s = 0; s < move->k - 1; s++) {
+
+        int from = move->idx[move->order[s] - 1] + 1 - first;
+        int to = move->idx[move->order[s]] - first;
+
+        if (!move->reversed[s]) {
+
+            for (int p = from; p <= to; p++) sol->visited_nodes[pos++] = scratch[p];
+
+        } else {
+
+            for (int p = to; p >= from; p--) sol->visited_nodes[pos++] = scratch[p];
+
+        }
+
+    }
+
+    // The cached edges from first-1 to last are the ones that changed
+    if (sol->edge_cost != NULL) {
+
+        for (int p = first - 1; p <= last; p++) {
+
+            sol->edge_cost[p] = cost(sol->visited_nodes[p], sol->visited_nodes[p + 1], inst);
+
+        }
+
+    }
+
+}
+
+// Compute the delta cost of a k-opt move
+double kopt_delta(const instance *inst, const solution *sol, const kopt_move *move) {
+
+    const int *nodes = sol->visited_nodes;
+    double delta = 0.0;
+
+    for (int i = 0; i < move->k; i++) {
+
+        delta -= (sol->edge_cost != NULL) ? sol->edge_cost[move->idx[i]] : cost(nodes[move->idx[i]], nodes[move->idx[i] + 1], inst);
+
+    }
+
+    // Walk the new tour from the first removed edge: each segment is entered from its head
+    int prev = nodes[move->idx[0]];
+
+    for (int s = 0; s < move->k - 1; s++) {
+
+        int head = nodes[move->idx[move->order[s] - 1] + 1];
+        int tail = nodes[move->idx[move->order[s]]];
+
+        if (move->reversed[s]) { int temp = head; head = tail; tail = temp; }
+
+        delta += cost(prev, head, inst);
+        prev = tail;
+
+    }
+
+    delta += cost(prev, nodes[move->idx[move->k - 1] + 1], inst);
+
+    return delta;
+
+}
+
 //---------------------------------------- heuristics ----------------------------------------
 
 // Nearest Neighbor algorithm
@@ -147,9 +366,63 @@ void nearest_neighbor(const instance *inst, solution *sol, const int start) {
     int len = 1;
     sol->cost = 0;
 
+    // If the costs grow with the plane distance, query a kd-tree of the unvisited nodes.
+    // Ties are broken by the position in the array, as find_nearest_node() does, so the tour is the same
+    kd_tree tree;
+    int *position = NULL;
+
+    // Otherwise, in matrix-free mode keep the coordinates in the same order of the nodes,
+    // so that the distances to the unvisited nodes are read from contiguous memory
+    double *xs = NULL;
+    double *ys = NULL;
+    cost_t *buffer = NULL;
+
+    if (kd_tree_supports(inst)) {
+
+        build_kd_tree(&tree, inst->x, inst->y, inst->nnodes);
+        kd_tree_delete(&tree, start);
+
+        position = (int *) malloc(inst->nnodes * sizeof(int));
+        if (position == NULL) print_error("nearest_neighbor(): Cannot allocate memory");
+
+        for (int i = 0; i < inst->nnodes; i++) position[sol->visited_nodes[i]] = i;
+
+    } else if (inst->costs == NULL && inst->x != NULL) {
+
+        xs = (double *) _aligned_malloc(inst->nnodes * sizeof(double), SIMD_ALIGNMENT);
+        ys = (double *) _aligned_malloc(inst->nnodes * sizeof(double), SIMD_ALIGNMENT);
+        buffer = (cost_t *) _aligned_malloc(inst->nnodes * sizeof(cost_t), SIMD_ALIGNMENT);
+
+        if (xs == NULL || ys == NULL || buffer == NULL) print_error("nearest_neighbor(): Cannot allocate memory");
+
+        for (int i = 0; i < inst->nnodes; i++) {
+
+            xs[i] = inst->x[sol->visited_nodes[i]];
+            ys[i] = inst->y[sol->visited_nodes[i]];
+
+        }
+
+    }
+
     for (int i = 1; i < inst->nnodes; i++) {
 
-        int nearest_index = find_nearest_node(inst, len, sol->visited_nodes);
+        int nearest_index;
+        double nearest_cost = INFINITY;
+
+        if (position != NULL) {
+
+            int node = kd_tree_nearest_alive(&tree, sol->visited_nodes[len - 1], position, inst, &nearest_cost);
+            nearest_index = (node == -1) ? -1 : position[node];
+
+        } else if (xs != NULL) {
+
+            nearest_index = find_nearest_point(inst, len, xs, ys, buffer);
+
+        } else {
+
+            nearest_index = find_nearest_node(inst, len, sol->visited_nodes);
+
+        }
 
         if (nearest_index == -1) {
 
@@ -160,12 +433,47 @@ void nearest_neighbor(const instance *inst, solution *sol, const int start) {
         // Update tour with nearest node
         int nearest_node = sol->visited_nodes[nearest_index];
         swap_nodes(sol->visited_nodes, nearest_index, len);
-        sol->cost += cost(sol->visited_nodes[len - 1], nearest_node, inst);
+        sol->cost += (position != NULL) ? nearest_cost : cost(sol->visited_nodes[len - 1], nearest_node, inst);
+
+        if (position != NULL) {
+
+            position[sol->visited_nodes[nearest_index]] = nearest_index;
+            position[nearest_node] = len;
+            kd_tree_delete(&tree, nearest_node);
+
+        }
+
+        if (xs != NULL) {
+
+            double temp = xs[nearest_index];
+            xs[nearest_index] = xs[len];
+            xs[len] = temp;
+
+            temp = ys[nearest_index];
+            ys[nearest_index] = ys[len];
+            ys[len] = temp;
+
+        }
 
         len++;
 
     }
 
+    if (position != NULL) {
+
+        free(position);
+        free_kd_tree(&tree);
+
+    }
+
+    if (xs != NULL) {
+
+        _aligned_free(xs);
+        _aligned_free(ys);
+        _aligned_free(buffer);
+
+    }
+
     // Complete the cycle
     sol->visited_nodes[inst->nnodes] = start;
     sol->cost += cost(sol->visited_nodes[len - 1], start, inst);
@@ -207,7 +515,7 @@ void multi_start_nn(const instance *inst, solution *sol, const double timelimit)
         // Refinement if asked
         if (inst->param1 == 1) {
 
-            two_opt(inst, &temp_sol, residual_time, false);
+            local_search(inst, &temp_sol, residual_time, false);
 
         }
 
@@ -343,7 +651,7 @@ void extra_mileage(const instance *inst, solution *sol) {
     sol->visited_nodes[inst->nnodes] = sol->visited_nodes[0];
 
     // Calculate the total cost of the complete tour
-    sol->cost = compute_solution_cost(inst, sol);
+    recompute_solution_cost(inst, sol);
 
     if (inst->verbose >= GOOD) {
 
@@ -367,29 +675,34 @@ void two_opt(const instance *inst, solution *sol, const double timelimit, bool p
     int improved = true; // Flag to track improvements
     double residual_time;
 
+    two_opt_scan scan;
+    two_opt_scan_init(&scan, inst);
+
     while (improved && ((residual_time = timelimit - get_elapsed_time(t_start)) > 0)) {
 
         double best_delta = INFINITY;
         int best_i = -1, best_j = -1;
 
         improved = false;
+        two_opt_scan_load(&scan, inst, sol);
 
-        // Get the best delta
-        for (int i = 1; i < inst->nnodes; i++) {
+        // Get the best delta, one row of moves (i, i+1..n-1) at a time
+        for (int i = 1; i < inst->nnodes - 1; i++) {
 
-            for (int j = i + 1; j < inst->nnodes; j++) {
+            if (get_elapsed_time(t_start) >= timelimit) break;
 
-                if (get_elapsed_time(t_start) >= timelimit) break;
-                
-                double delta = delta2(inst, sol, i, j);
+            int count = inst->nnodes - 1 - i;
+            const double *delta = two_opt_scan_row(&scan, inst, i, i + 1, inst->nnodes - 1);
+            double row_best = min_delta(delta, count);
 
-                if (delta < best_delta- EPSILON) {
+            if (row_best < best_delta - EPSILON) {
 
-                    best_delta = delta;
-                    best_i = i;
-                    best_j = j;
+                int k = 0;
+                while (delta[k] != row_best) k++;
 
-                }
+                best_delta = row_best;
+                best_i = i;
+                best_j = i + 1 + k;
 
             }
 
@@ -404,7 +717,7 @@ void two_opt(const instance *inst, solution *sol, const double timelimit, bool p
             }
 
             // Reverse the segment between i and j
-            reverse_segment(sol, best_i, best_j);
+            apply_two_opt_move(inst, sol, best_i, best_j);
             
             // Update the solution cost correctly
             sol->cost += best_delta;
@@ -421,6 +734,16 @@ void two_opt(const instance *inst, solution *sol, const double timelimit, bool p
 
     }
 
+    if (print && inst->verbose >= LOW) {
+
+        double scan_time = get_elapsed_time(t_start);
+        printf("2-opt: %.0lf moves evaluated per second (%lld moves in %lf seconds, %s scan)\n", 
+            (scan_time > 0.0) ? scan.moves / scan_time : 0.0, scan.moves, scan_time, scan.vectorized ? SIMD_NAME : "scalar");
+
+    }
+
+    two_opt_scan_free(&scan);
+
     if (updated && is_asked_method) {
 
         strncpy_s(sol->method, METH_NAME_LEN, TWO_OPT, _TRUNCATE);
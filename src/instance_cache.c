@@ -0,0 +1,349 @@
+#include "instance_cache.h"
+
+// Load the instance from a cache file, if it is valid
+bool load_instance_cache(instance *inst, const char *filename, const unsigned long long source_hash, const bool check_source) {
+
+    double t_start = get_time_in_milliseconds();
+
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < (LONGLONG) sizeof(cache_header)) {
+
+        CloseHandle(file);
+        return false;
+
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const char *data = (mapping != NULL) ? (const char *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+    // The view keeps the file mapped: the handles are not needed anymore
+    if (mapping != NULL) CloseHandle(mapping);
+    CloseHandle(file);
+
+    if (data == NULL) return false;
+
+    // The cache must be readable by this build
+    const cache_header *header = (const cache_header *) data;
+
+    bool valid = strncmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->file_size == (unsigned long long) file_size.QuadPart &&
+                 strncmp(header->cost_type, COST_TYPE_NAME, sizeof(header->cost_type)) == 0 &&
+                 header->cost_size == (int) sizeof(cost_t);
+
+    // and, if asked, come from the same input file and match the options of this run
+    if (valid && check_source) {
+
+        int cand_k = (inst->cand_k < header->nnodes - 1) ? inst->cand_k : header->nnodes - 1;
+        double megabytes = (double) cost_matrix_size(header->nnodes, inst->cost_layout) * sizeof(cost_t) / (1024.0 * 1024.0);
+        bool matrix_free = (megabytes > inst->cost_memory && header->edge_weight_type != EXPLICIT);
+
+        valid = header->source_hash == source_hash &&
+                header->cand_k == cand_k &&
+                header->hilbert == (inst->hilbert ? 1 : 0) &&
+                header->has_costs == (matrix_free ? 0 : 1) &&
+                (matrix_free || header->cost_layout == (int) inst->cost_layout);
+
+    }
+
+    if (!valid) {
+
+        UnmapViewOfFile(data);
+
+        if (inst->verbose >= LOW) {
+
+            if (check_source) printf("Cache %s is out of date: rebuilding it\n", filename);
+            else printf("Cannot read %s: not a cache file of this build (%s costs)\n", filename, COST_TYPE_NAME);
+
+        }
+
+        return false;
+
+    }
+
+    inst->nnodes = header->nnodes;
+    inst->edge_weight_type = (EdgeWeightType) header->edge_weight_type;
+    inst->hilbert = header->hilbert;
+    inst->cand_k = header->cand_k;
+    inst->cache_view = (void *) data;
+
+    // Coordinates are copied: they are small and the other modules own them
+    if (header->has_coord) {
+
+        const double *x = (const double *) (data + header->offset_x);
+        const double *y = (const double *) (data + header->offset_y);
+
+        inst->coord = (coordinate *) malloc(inst->nnodes * sizeof(coordinate));
+        if (inst->coord == NULL) print_error("load_instance_cache(): Cannot allocate memory");
+
+        for (int i = 0; i < inst->nnodes; i++) {
+
+            inst->coord[i].x = x[i];
+            inst->coord[i].y = y[i];
+
+        }
+
+        build_coordinate_arrays(inst);
+
+    }
+
+    // Costs and candidate lists stay in the mapping: only the pages used are read from disk
+    inst->costs = header->has_costs ? (cost_t *) (data + header->offset_costs) : NULL;
+    inst->cost_layout = (CostLayout) header->cost_layout;
+    if (inst->costs != NULL) build_tile_index(inst);
+
+    if (header->cand_k > 0) {
+
+        inst->cand = (int *) (data + header->offset_cand);
+        inst->cand_cost = (cost_t *) (data + header->offset_cand_cost);
+
+    }
+
+    if (header->offset_original_id != 0) {
+
+        inst->original_id = (int *) malloc(inst->nnodes * sizeof(int));
+        if (inst->original_id == NULL) print_error("load_instance_cache(): Cannot allocate memory");
+
+        memcpy(inst->original_id, data + header->offset_original_id, inst->nnodes * sizeof(int));
+
+    }
+
+    // Allocate the best solution
+    inst->best_solution = (solution *) malloc(sizeof(solution));
+    if (inst->best_solution == NULL) print_error("load_instance_cache(): Cannot allocate memory");
+
+    initialize_solution(inst->best_solution);
+    allocate_solution(inst->best_solution, inst->nnodes);
+
+    if (inst->verbose >= LOW) {
+
+        printf("Loaded %s in %lf seconds\n", filename, get_elapsed_time(t_start));
+
+    }
+
+    return true;
+
+}
+
+// Write the cache file of a built instance
+bool save_instance_cache(const instance *inst, const char *filename, const unsigned long long source_hash) {
+
+    double t_start = get_time_in_milliseconds();
+
+    size_t n = (size_t) inst->nnodes;
+    size_t ncand = n * (inst->cand != NULL ? inst->cand_k : 0);
+
+    // Layout of the sections
+    cache_header header;
+    memset(&header, 0, sizeof(header));
+
+    strncpy_s(header.magic, sizeof(header.magic), CACHE_MAGIC, _TRUNCATE);
+    strncpy_s(header.cost_type, sizeof(header.cost_type), COST_TYPE_NAME, _TRUNCATE);
+    header.source_hash = source_hash;
+    header.cost_size = (int) sizeof(cost_t);
+    header.nnodes = inst->nnodes;
+    header.edge_weight_type = (int) inst->edge_weight_type;
+    header.cand_k = (inst->cand != NULL) ? inst->cand_k : 0;
+    header.hilbert = inst->hilbert ? 1 : 0;
+    header.has_coord = (inst->x != NULL) ? 1 : 0;
+    header.has_costs = (inst->costs != NULL) ? 1 : 0;
+    header.cost_layout = (int) inst->cost_layout;
+
+    unsigned long long offset = cache_align(sizeof(cache_header));
+
+    if (header.has_coord) {
+
+        header.offset_x = offset;
+        offset = cache_align(offset + n * sizeof(double));
+        header.offset_y = offset;
+        offset = cache_align(offset + n * sizeof(double));
+
+    }
+
+    if (header.has_costs) {
+
+        header.offset_costs = offset;
+        offset = cache_align(offset + cost_matrix_size(inst->nnodes, inst->cost_layout) * sizeof(cost_t));
+
+    }
+
+    if (ncand > 0) {
+
+        header.offset_cand = offset;
+        offset = cache_align(offset + ncand * sizeof(int));
+        header.offset_cand_cost = offset;
+        offset = cache_align(offset + ncand * sizeof(cost_t));
+
+    }
+
+    if (inst->original_id != NULL) {
+
+        header.offset_original_id = offset;
+        offset = cache_align(offset + n * sizeof(int));
+
+    }
+
+    header.file_size = offset;
+
+    // Write the header and the sections in order
+    FILE *f = NULL;
+
+    if (fopen_s(&f, filename, "wb") || f == NULL) {
+
+        if (inst->verbose >= LOW) printf("Cannot write the cache %s: skipped\n", filename);
+        return false;
+
+    }
+
+    bool ok = fwrite(&header, sizeof(cache_header), 1, f) == 1;
+
+    if (ok && header.has_coord) {
+
+        ok = write_cache_section(f, header.offset_x, inst->x, n * sizeof(double)) &&
+             write_cache_section(f, header.offset_y, inst->y, n * sizeof(double));
+
+    }
+
+    if (ok && header.has_costs) ok = write_cache_section(f, header.offset_costs, inst->costs, cost_matrix_size(inst->nnodes, inst->cost_layout) * sizeof(cost_t));
+
+    if (ok && ncand > 0) {
+
+        ok = write_cache_section(f, header.offset_cand, inst->cand, ncand * sizeof(int)) &&
+             write_cache_section(f, header.offset_cand_cost, inst->cand_cost, ncand * sizeof(cost_t));
+
+    }
+
+    if (ok && inst->original_id != NULL) ok = write_cache_section(f, header.offset_original_id, inst->original_id, n * sizeof(int));
+
+    // Pad the last section, so that the file size is the one in the header
+    if (ok) ok = write_cache_section(f, header.file_size, NULL, 0);
+
+    fclose(f);
+
+    if (!ok) {
+
+        // Do not leave a broken cache behind
+        remove(filename);
+        if (inst->verbose >= LOW) printf("Cannot write the cache %s: skipped\n", filename);
+        return false;
+
+    }
+
+    if (inst->verbose >= LOW) {
+
+        printf("Written %s (%.1lf MB) in %lf seconds\n", filename, (double) header.file_size / (1024.0 * 1024.0), get_elapsed_time(t_start));
+
+    }
+
+    return true;
+
+}
+
+// Release the mapping of the cache file
+void close_instance_cache(instance *inst) {
+
+    if (inst->cache_view == NULL) return;
+
+    // The arrays inside the mapping are not owned by the instance
+    inst->costs = NULL;
+    inst->cand = NULL;
+    inst->cand_cost = NULL;
+
+    UnmapViewOfFile(inst->cache_view);
+    inst->cache_view = NULL;
+
+}
+
+// Hash the content of a file with FNV-1a
+bool hash_file(const char *filename, unsigned long long *hash) {
+
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+
+        CloseHandle(file);
+        return false;
+
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const unsigned char *data = (mapping != NULL) ? (const unsigned char *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+    if (data == NULL) {
+
+        if (mapping != NULL) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+
+    }
+
+    unsigned long long h = FNV_OFFSET_BASIS;
+
+    for (LONGLONG i = 0; i < file_size.QuadPart; i++) {
+
+        h ^= data[i];
+        h *= FNV_PRIME;
+
+    }
+
+    *hash = h;
+
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    CloseHandle(file);
+
+    return true;
+
+}
+
+// Build the path of the cache file
+bool cache_file_name(const instance *inst, char *filename) {
+
+    // sprintf_s() would abort on a path that does not fit
+    if (strlen(inst->input_file) + strlen(CACHE_EXTENSION) >= FILE_NAME_LEN) {
+
+        if (inst->verbose >= LOW) printf("Path of the cache of %s too long: cache skipped\n", inst->input_file);
+        return false;
+
+    }
+
+    sprintf_s(filename, FILE_NAME_LEN, "%s%s", inst->input_file, CACHE_EXTENSION);
+
+    return true;
+
+}
+
+// Check if a path names a cache file
+bool is_cache_file(const char *filename) {
+
+    size_t len = strlen(filename);
+    size_t suffix_len = strlen(CACHE_FILE_SUFFIX);
+
+    return len > suffix_len && _stricmp(filename + len - suffix_len, CACHE_FILE_SUFFIX) == 0;
+
+}
+
+// Write a section of the cache file at its offset
+bool write_cache_section(FILE *f, const unsigned long long offset, const void *data, const size_t size) {
+
+    static const char zeros[CACHE_ALIGNMENT] = {0};
+
+    // Pad up to the offset of the section
+    unsigned long long position = (unsigned long long) _ftelli64(f);
+    if (position > offset) return false;
+
+    while (position < offset) {
+
+        size_t chunk = (offset - position < CACHE_ALIGNMENT) ? (size_t) (offset - position) : CACHE_ALIGNMENT;
+        if (fwrite(zeros, 1, chunk, f) != chunk) return false;
+        position += chunk;
+
+    }
+
+    return size == 0 || fwrite(data, 1, size, f) == size;
+
+}
@@ -0,0 +1,355 @@
+#include "kd_tree.h"
+
+// Build a kd-tree over a set of points
+void build_kd_tree(kd_tree *tree, const double *x, const double *y, const int npoints) {
+
+    tree->x = x;
+    tree->y = y;
+    tree->npoints = npoints;
+    tree->nnodes = 0;
+
+    // Leaves hold at least KD_BUCKET/2 points, and there are less than twice as many nodes as leaves
+    int max_nodes = 2 * (npoints / (KD_BUCKET / 2) + 1);
+
+    tree->perm = (int *) malloc(npoints * sizeof(int));
+    tree->nodes = (kd_node *) malloc(max_nodes * sizeof(kd_node));
+    tree->px = (double *) malloc(npoints * sizeof(double));
+    tree->py = (double *) malloc(npoints * sizeof(double));
+    tree->leaf = (int *) malloc(npoints * sizeof(int));
+    tree->deleted = (bool *) calloc(npoints, sizeof(bool));
+
+    if (tree->perm == NULL || tree->nodes == NULL || tree->px == NULL || tree->py == NULL || tree->leaf == NULL || tree->deleted == NULL) {
+
+        print_error("build_kd_tree(): Cannot allocate memory");
+
+    }
+
+    for (int i = 0; i < npoints; i++) {
+
+        tree->perm[i] = i;
+        tree->px[i] = x[i];
+        tree->py[i] = y[i];
+
+    }
+
+    build_kd_node(tree, 0, npoints, -1);
+
+}
+
+// Free the memory of a kd-tree
+void free_kd_tree(kd_tree *tree) {
+
+    if (tree->perm != NULL) {
+
+        free(tree->perm);
+        tree->perm = NULL;
+
+    }
+
+    if (tree->nodes != NULL) {
+
+        free(tree->nodes);
+        tree->nodes = NULL;
+
+    }
+
+    if (tree->px != NULL) {
+
+        free(tree->px);
+        tree->px = NULL;
+
+    }
+
+    if (tree->py != NULL) {
+
+        free(tree->py);
+        tree->py = NULL;
+
+    }
+
+    if (tree->leaf != NULL) {
+
+        free(tree->leaf);
+        tree->leaf = NULL;
+
+    }
+
+    if (tree->deleted != NULL) {
+
+        free(tree->deleted);
+        tree->deleted = NULL;
+
+    }
+
+    tree->nnodes = 0;
+
+}
+
+// Build recursively the subtree over a range of points
+int build_kd_node(kd_tree *tree, const int begin, const int end, const int parent) {
+
+    int index = tree->nnodes++;
+    kd_node *node = &tree->nodes[index];
+
+    node->begin = begin;
+    node->end = end;
+    node->left = -1;
+    node->right = -1;
+    node->parent = parent;
+    node->alive = end - begin;
+    node->dim = 0;
+    node->split = 0.0;
+
+    // Bounding box of the points
+    node->xmin = INFINITY;
+    node->xmax = -INFINITY;
+    node->ymin = INFINITY;
+    node->ymax = -INFINITY;
+
+    for (int i = begin; i < end; i++) {
+
+        if (tree->px[i] < node->xmin) node->xmin = tree->px[i];
+        if (tree->px[i] > node->xmax) node->xmax = tree->px[i];
+        if (tree->py[i] < node->ymin) node->ymin = tree->py[i];
+        if (tree->py[i] > node->ymax) node->ymax = tree->py[i];
+
+    }
+
+    if (end - begin <= KD_BUCKET) {
+
+        for (int i = begin; i < end; i++) tree->leaf[tree->perm[i]] = index;
+
+        return index;
+
+    }
+
+    // Split at the median of the widest dimension
+    int dim = (node->xmax - node->xmin >= node->ymax - node->ymin) ? 0 : 1;
+    int mid = begin + (end - begin) / 2;
+
+    kd_select(tree, begin, end, mid, dim);
+
+    node->dim = dim;
+    node->split = (dim == 0) ? tree->px[mid] : tree->py[mid];
+
+    // NOTE: node may be moved by the children, so it is accessed again by index
+    int left = build_kd_node(tree, begin, mid, index);
+    int right = build_kd_node(tree, mid, end, index);
+
+    tree->nodes[index].left = left;
+    tree->nodes[index].right = right;
+
+    return index;
+
+}
+
+// Reorder a range of points around its k-th smallest coordinate
+void kd_select(kd_tree *tree, int begin, int end, const int k, const int dim) {
+
+    double *coord = (dim == 0) ? tree->px : tree->py;
+    double *other = (dim == 0) ? tree->py : tree->px;
+    int *perm = tree->perm;
+
+    while (end - begin > 1) {
+
+        // Hoare partition around the middle element
+        double pivot = coord[begin + (end - begin) / 2];
+        int i = begin;
+        int j = end - 1;
+
+        while (i <= j) {
+
+            while (coord[i] < pivot) i++;
+            while (coord[j] > pivot) j--;
+
+            if (i <= j) {
+
+                // Move the point with both its coordinates
+                int temp = perm[i];
+                perm[i] = perm[j];
+                perm[j] = temp;
+
+                double temp_coord = coord[i];
+                coord[i] = coord[j];
+                coord[j] = temp_coord;
+
+                temp_coord = other[i];
+                other[i] = other[j];
+                other[j] = temp_coord;
+
+                i++;
+                j--;
+
+            }
+
+        }
+
+        // Now [begin, j] <= pivot, [i, end) >= pivot and the elements between them are equal to the pivot
+        if (k <= j) {
+
+            end = j + 1;
+
+        } else if (k >= i) {
+
+            begin = i;
+
+        } else {
+
+            return;
+
+        }
+
+    }
+
+}
+
+// Find the k points nearest to a point of the tree
+int kd_tree_k_nearest(const kd_tree *tree, const int point, const int k, int *nearest, double *dist2) {
+
+    int found = 0;
+
+    if (tree->nnodes > 0 && k > 0) kd_search_k_nearest(tree, 0, point, k, nearest, dist2, &found);
+
+    return found;
+
+}
+
+// Visit recursively a subtree looking for the k nearest points
+void kd_search_k_nearest(const kd_tree *tree, const int node, const int point, const int k, int *nearest, double *dist2, int *found) {
+
+    const kd_node *current = &tree->nodes[node];
+    double x = tree->x[point];
+    double y = tree->y[point];
+
+    // Skip the subtree if it cannot contain a point nearer than the current k-th
+    if (*found == k && kd_box_dist2(current, x, y) > dist2[k - 1]) return;
+
+    if (current->left == -1) {
+
+        for (int i = current->begin; i < current->end; i++) {
+
+            int p = tree->perm[i];
+            if (p == point) continue;
+
+            double dx = tree->px[i] - x;
+            double dy = tree->py[i] - y;
+            double d2 = dx * dx + dy * dy;
+
+            // Insert in the sorted list of the nearest points, ties broken by index
+            if (*found == k && (d2 > dist2[k - 1] || (d2 == dist2[k - 1] && p > nearest[k - 1]))) continue;
+
+            int pos = (*found < k) ? (*found)++ : k - 1;
+
+            while (pos > 0 && (dist2[pos - 1] > d2 || (dist2[pos - 1] == d2 && nearest[pos - 1] > p))) {
+
+                nearest[pos] = nearest[pos - 1];
+                dist2[pos] = dist2[pos - 1];
+                pos--;
+
+            }
+
+            nearest[pos] = p;
+            dist2[pos] = d2;
+
+        }
+
+        return;
+
+    }
+
+    // Visit first the child on the same side of the point
+    double value = (current->dim == 0) ? x : y;
+    int first = (value <= current->split) ? current->left : current->right;
+    int second = (value <= current->split) ? current->right : current->left;
+
+    kd_search_k_nearest(tree, first, point, k, nearest, dist2, found);
+    kd_search_k_nearest(tree, second, point, k, nearest, dist2, found);
+
+}
+
+// Delete a point from the tree
+void kd_tree_delete(kd_tree *tree, const int point) {
+
+    if (tree->deleted[point]) return;
+
+    tree->deleted[point] = true;
+
+    for (int node = tree->leaf[point]; node != -1; node = tree->nodes[node].parent) {
+
+        tree->nodes[node].alive--;
+
+    }
+
+}
+
+// Compute the cost between the query point and a point of a leaf
+double kd_point_cost(const kd_tree *tree, const int i, const double x, const double y, const int point, const int p, const instance *inst) {
+
+    if (inst->costs != NULL) return cost(point, p, inst);
+
+    switch (inst->edge_weight_type) {
+
+        case EUC_2D:    return (double) to_cost(euc_2d_dist(x, y, tree->px[i], tree->py[i]));
+        case CEIL_2D:   return (double) to_cost(ceil_2d_dist(x, y, tree->px[i], tree->py[i]));
+        case ATT:       return (double) to_cost(att_dist(x, y, tree->px[i], tree->py[i]));
+        default:        return (double) to_cost(dist(x, y, tree->px[i], tree->py[i]));
+
+    }
+
+}
+
+// Find the point not deleted with the minimum cost from a point
+int kd_tree_nearest_alive(const kd_tree *tree, const int point, const int *rank, const instance *inst, double *nearest_cost) {
+
+    int best = -1;
+    *nearest_cost = INFINITY;
+
+    if (tree->nnodes > 0) kd_search_nearest_alive(tree, 0, point, rank, inst, &best, nearest_cost);
+
+    return best;
+
+}
+
+// Visit recursively a subtree looking for the nearest point not deleted
+void kd_search_nearest_alive(const kd_tree *tree, const int node, const int point, const int *rank, const instance *inst, int *best, double *best_cost) {
+
+    const kd_node *current = &tree->nodes[node];
+    double x = tree->x[point];
+    double y = tree->y[point];
+
+    // Skip empty subtrees and those that cannot contain a cheaper point (ties are still visited)
+    if (current->alive == 0) return;
+    if (*best != -1 && kd_box_cost(current, x, y, inst) > *best_cost) return;
+
+    if (current->left == -1) {
+
+        for (int i = current->begin; i < current->end; i++) {
+
+            int p = tree->perm[i];
+            if (tree->deleted[p] || p == point) continue;
+
+            double c = kd_point_cost(tree, i, x, y, point, p, inst);
+
+            if (*best == -1 || c < *best_cost ||
+                (c == *best_cost && ((rank != NULL) ? rank[p] < rank[*best] : p < *best))) {
+
+                *best = p;
+                *best_cost = c;
+
+            }
+
+        }
+
+        return;
+
+    }
+
+    // Visit first the child on the same side of the point
+    double value = (current->dim == 0) ? x : y;
+    int first = (value <= current->split) ? current->left : current->right;
+    int second = (value <= current->split) ? current->right : current->left;
+
+    kd_search_nearest_alive(tree, first, point, rank, inst, best, best_cost);
+    kd_search_nearest_alive(tree, second, point, rank, inst, best, best_cost);
+
+}
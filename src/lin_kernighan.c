@@ -0,0 +1,355 @@
+#include "lin_kernighan.h"
+
+// Lin-Kernighan local search over the candidate lists, with don't-look bits
+void lin_kernighan(const instance *inst, solution *sol, const double timelimit, bool print) {
+
+    if (inst->cand == NULL) {
+
+        if (inst->verbose >= LOW) printf("No candidate lists: using the full 2-opt\n");
+        two_opt(inst, sol, timelimit, print);
+        return;
+
+    }
+
+    double t_start = get_time_in_milliseconds();
+
+    int n = inst->nnodes;
+    double old_cost = sol->cost;
+    int moves = 0;
+
+    tour t;
+    tour_init(&t, sol, inst);
+    tour_start_log(&t);
+
+    work_queue q;
+    queue_init(&q, sol->visited_nodes, n);
+
+    lk_step *steps = (lk_step *) malloc(inst->lk_depth * sizeof(lk_step));
+    if (steps == NULL) print_error("lin_kernighan(): Cannot allocate memory");
+
+    lk_optimize(inst, &t, &q, steps, t_start, timelimit, false, &moves);
+
+    free(steps);
+    queue_free(&q);
+    tour_to_solution(&t);
+    tour_free(&t);
+
+    // The gains accumulate rounding errors: the cost is the one of the final tour
+    if (moves > 0) recompute_solution_cost(inst, sol);
+
+    if (print && moves > 0 && inst->verbose >= ONLY_INCUMBENT) {
+
+        printf(" * LK: Old cost %10.6lf, New cost %10.6lf, Moves %d, Time %10.6lf\n", old_cost, sol->cost, moves, get_elapsed_time(t_start));
+
+    }
+
+    if (inst->verbose >= GOOD) {
+
+        check_sol(inst, sol);
+
+    }
+
+}
+
+// Chained Lin-Kernighan
+void chained_lin_kernighan(const instance *inst, solution *sol, const double timelimit) {
+
+    int n = inst->nnodes;
+
+    // No room for the kicks
+    if (inst->cand == NULL || n < 8) {
+
+        lin_kernighan(inst, sol, timelimit, true);
+        return;
+
+    }
+
+    double t_start = get_time_in_milliseconds();
+    bool is_asked_method = (strcmp(inst->asked_method, LIN_KERNIGHAN) == 0);
+
+    double old_cost = sol->cost;
+    int moves = 0;
+
+    tour t;
+    tour_init(&t, sol, inst);
+    tour_start_log(&t);
+
+    work_queue q;
+    queue_init(&q, sol->visited_nodes, n);
+
+    lk_step *steps = (lk_step *) malloc(inst->lk_depth * sizeof(lk_step));
+    if (steps == NULL) print_error("chained_lin_kernighan(): Cannot allocate memory");
+
+    FILE* f = NULL;
+    if (inst->verbose >= ONLY_INCUMBENT && is_asked_method) {
+
+        char filename[FILE_NAME_LEN];
+        sprintf_s(filename, FILE_NAME_LEN, "results/%s.csv", LIN_KERNIGHAN);
+        fopen_s(&f, filename, "w+");
+
+    }
+
+    // Local optimum of the starting tour
+    double current = sol->cost - lk_optimize(inst, &t, &q, steps, t_start, timelimit, true, &moves);
+    t.log_len = 0;
+
+    if (inst->verbose >= GOOD) {
+
+        printf("LK: Starting cost %10.6lf, Local optimum %10.6lf, Time %10.6lf\n", old_cost, current, get_elapsed_time(t_start));
+
+    }
+
+    int iteration = 0;
+
+    while (get_elapsed_time(t_start) < timelimit) {
+
+        // Kick: a -> [a' ... b] [b' ... c] [c' ... d] -> d' becomes a -> [c' ... d] [b' ... c] [a' ... b] -> d'
+        int len1 = 1 + rand() % LK_KICK_SEGMENT;
+        int len2 = 1 + rand() % LK_KICK_SEGMENT;
+        int len3 = 1 + rand() % LK_KICK_SEGMENT;
+        if (len1 + len2 + len3 + 1 > n) len1 = len2 = len3 = 1;
+
+        int a = rand() % n;
+        int b = a, c, d;
+        for (int i = 0; i < len1; i++) b = tour_next(&t, b);
+        c = b;
+        for (int i = 0; i < len2; i++) c = tour_next(&t, c);
+        d = c;
+        for (int i = 0; i < len3; i++) d = tour_next(&t, d);
+
+        int a2 = tour_next(&t, a);
+        int b2 = tour_next(&t, b);
+        int c2 = tour_next(&t, c);
+        int d2 = tour_next(&t, d);
+
+        double delta = cost(a, c2, inst) + cost(d, b2, inst) + cost(c, a2, inst) + cost(b, d2, inst) -
+                       cost(a, a2, inst) - cost(b, b2, inst) - cost(c, c2, inst) - cost(d, d2, inst);
+
+        tour_double_bridge(&t, a, b, c, d);
+
+        // Lin-Kernighan from the nodes of the kick only
+        queue_push(&q, a);
+        queue_push(&q, a2);
+        queue_push(&q, b);
+        queue_push(&q, b2);
+        queue_push(&q, c);
+        queue_push(&q, c2);
+        queue_push(&q, d);
+        queue_push(&q, d2);
+
+        double new_cost = current + delta - lk_optimize(inst, &t, &q, steps, t_start, timelimit, true, &moves);
+
+        if (new_cost < current - EPSILON) {
+
+            if (inst->verbose >= GOOD) {
+
+                printf(" * Iteration %8d, Incumbent %10.6lf, Heuristic solution cost %10.6lf, Residual time %10.6lf\n",
+                    iteration, current, new_cost, timelimit - get_elapsed_time(t_start));
+
+            }
+
+            current = new_cost;
+            t.log_len = 0;
+
+        } else {
+
+            // Back to the incumbent: undo the kick and the moves after it
+            tour_undo(&t, 0);
+            while (q.count > 0) queue_pop(&q);
+
+        }
+
+        if (f != NULL) fprintf(f, "%d,%f,%f\n", iteration, new_cost, current);
+
+        iteration++;
+
+    }
+
+    free(steps);
+    queue_free(&q);
+    tour_to_solution(&t);
+    tour_free(&t);
+
+    recompute_solution_cost(inst, sol);
+
+    if (sol->cost < old_cost - EPSILON) {
+
+        strncpy_s(sol->method, METH_NAME_LEN, LIN_KERNIGHAN, _TRUNCATE);
+
+    }
+
+    if (inst->verbose >= LOW) {
+
+        printf("LK: Old cost %10.6lf, New cost %10.6lf, Kicks %d, Time %10.6lf\n", old_cost, sol->cost, iteration, get_elapsed_time(t_start));
+
+    }
+
+    if (inst->verbose >= GOOD) {
+
+        check_sol(inst, sol);
+
+    }
+
+    // Close the file if it was opened
+    if (f != NULL) {
+
+        fclose(f);
+        plot_stats_in_file(LIN_KERNIGHAN);
+
+    }
+
+}
+
+// Apply Lin-Kernighan moves from the nodes in the work queue
+double lk_optimize(const instance *inst, tour *t, work_queue *q, lk_step *steps, const double t_start, const double timelimit, const bool keep_log, int *moves) {
+
+    double total_gain = 0.0;
+
+    while (q->count > 0 && get_elapsed_time(t_start) < timelimit) {
+
+        int t1 = queue_pop(q);
+        int depth = 0;
+
+        // First step: all the candidates of both neighbors of t1, until a move improves the tour
+        for (int dir = 0; dir < 2 && depth == 0; dir++) {
+
+            int t2 = (dir == 0) ? tour_next(t, t1) : tour_prev(t, t1);
+            double g0 = cost(t1, t2, inst);
+
+            const int *list = candidates(t2, inst);
+            const cost_t *list_cost = candidate_costs(t2, inst);
+
+            for (int k = 0; k < inst->cand_k && depth == 0; k++) {
+
+                // Gain criterion: the lists are sorted, no later candidate gives a positive gain
+                if (g0 - (double) list_cost[k] <= EPSILON) break;
+
+                int t3 = list[k];
+                if (t3 == t1) continue;
+
+                int t4 = (tour_next(t, t1) == t2) ? tour_prev(t, t3) : tour_next(t, t3);
+                if (t4 == t2) continue;
+
+                total_gain += lk_move(inst, t, t1, t2, t3, steps, &depth);
+
+            }
+
+        }
+
+        if (depth == 0) continue;
+
+        // Nothing undoes a move once it is applied: the log is needed only inside lk_move()
+        if (!keep_log) t->log_len = 0;
+
+        // Switch off the don't-look bits of the nodes of the move
+        (*moves)++;
+        queue_push(q, t1);
+
+        for (int i = 0; i < depth; i++) {
+
+            queue_push(q, steps[i].t2);
+            queue_push(q, steps[i].t3);
+            queue_push(q, steps[i].t4);
+
+        }
+
+    }
+
+    return total_gain;
+
+}
+
+// Build a Lin-Kernighan move from t1, with the first step fixed
+double lk_move(const instance *inst, tour *t, const int t1, const int t2, const int t3, lk_step *steps, int *depth) {
+
+    int mark = t->log_len;
+
+    // Gain of the open path: cost of the removed edges minus the cost of the added ones
+    double g = cost(t1, t2, inst);
+    double best_gain = EPSILON;
+    int best_depth = 0;
+
+    int d = 0;
+    int u2 = t2, u3 = t3;
+
+    while (u3 >= 0 && d < inst->lk_depth) {
+
+        // Apply the step: (t1, t2), (t3, t4) become (t2, t3), (t4, t1)
+        int u4 = (tour_next(t, t1) == u2) ? tour_prev(t, u3) : tour_next(t, u3);
+
+        g += cost(u3, u4, inst) - cost(u2, u3, inst);
+        tour_2opt_move(t, t1, u2, u4, u3);
+
+        steps[d].t2 = u2;
+        steps[d].t3 = u3;
+        steps[d].t4 = u4;
+        d++;
+
+        double closed_gain = g - cost(u4, t1, inst);
+
+        if (closed_gain > best_gain) {
+
+            best_gain = closed_gain;
+            best_depth = d;
+
+        }
+
+        // Next step from t4: the candidate with the best gain of the step, keeping the gain of the path positive
+        u2 = u4;
+        u3 = -1;
+
+        bool forward = (tour_next(t, t1) == u2);
+        double best_step = -INF;
+
+        const int *list = candidates(u2, inst);
+        const cost_t *list_cost = candidate_costs(u2, inst);
+
+        for (int k = 0; k < inst->cand_k; k++) {
+
+            if (g - (double) list_cost[k] <= EPSILON) break;
+
+            int c = list[k];
+            if (c == t1) continue;
+
+            int c2 = forward ? tour_prev(t, c) : tour_next(t, c);
+            if (c2 == u2) continue;
+
+            // An edge removed is not added again, an edge added is not removed again
+            if (same_edge(u2, c, t1, t2) || lk_edge_in_steps(steps, d, u2, c, false) || lk_edge_in_steps(steps, d, c, c2, true)) continue;
+
+            double step = cost(c, c2, inst) - (double) list_cost[k];
+
+            if (step > best_step) {
+
+                best_step = step;
+                u3 = c;
+
+            }
+
+        }
+
+    }
+
+    // Cut the move back to its best closed tour
+    tour_undo(t, mark + best_depth);
+    *depth = best_depth;
+
+    return (best_depth > 0) ? best_gain : 0.0;
+
+}
+
+// Check if an edge is one of the edges added or removed by the steps of a Lin-Kernighan move
+bool lk_edge_in_steps(const lk_step *steps, const int depth, const int u, const int v, const bool added) {
+
+    for (int i = 0; i < depth; i++) {
+
+        int x = added ? steps[i].t2 : steps[i].t3;
+        int y = added ? steps[i].t3 : steps[i].t4;
+
+        if (same_edge(u, v, x, y)) return true;
+
+    }
+
+    return false;
+
+}
@@ -0,0 +1,953 @@
+#include "local_search.h"
+
+// Registry of the local searches: the order is the one of the help
+static const ls_operator LS_REGISTRY[] = {
+
+    {LS_2OPT,       LS_2OPT_NAME,       two_opt,        false},
+    {LS_2OPT_NL,    LS_2OPT_NL_NAME,    two_opt_nl,     true},
+    {LS_OR_OPT,     LS_OR_OPT_NAME,     or_opt,         true},
+    {LS_3OPT,       LS_3OPT_NAME,       three_opt,      true},
+    {LS_LK,         LS_LK_NAME,         lin_kernighan,  true},
+    {LS_2OPT_PAR,   LS_2OPT_PAR_NAME,   two_opt_par,    true},
+    {LS_DP_WINDOW,  LS_DP_WINDOW_NAME,  dp_window,      false}
+
+};
+
+#define LS_REGISTRY_SIZE ((int) (sizeof(LS_REGISTRY) / sizeof(LS_REGISTRY[0])))
+
+// Refine the solution with the chain of local searches asked
+void local_search(const instance *inst, solution *sol, const double timelimit, bool print) {
+
+    ls_chain chain;
+    build_local_search_chain(inst, &chain);
+
+    vnd(inst, &chain, sol, timelimit, print);
+
+}
+
+// Build the chain of local searches applied by local_search()
+void build_local_search_chain(const instance *inst, ls_chain *chain) {
+
+    *chain = inst->local_search;
+    bool has_or_opt = false, has_dp = false;
+
+    for (int k = 0; k < chain->len; k++) {
+
+        has_or_opt = has_or_opt || (chain->ops[k] == LS_OR_OPT);
+        has_dp = has_dp || (chain->ops[k] == LS_DP_WINDOW);
+
+    }
+
+    // -oropt and -dpwin append their local search to the chain
+    if (inst->or_opt && !has_or_opt && chain->len < LS_MAX_CHAIN) chain->ops[chain->len++] = LS_OR_OPT;
+    if (inst->dp_window > 0 && !has_dp && chain->len < LS_MAX_CHAIN) chain->ops[chain->len++] = LS_DP_WINDOW;
+
+}
+
+// Variable Neighborhood Descent over a chain of local searches
+void vnd(const instance *inst, const ls_chain *chain, solution *sol, const double timelimit, bool print) {
+
+    double t_start = get_time_in_milliseconds();
+    int k = 0;
+
+    while (k < chain->len && get_elapsed_time(t_start) < timelimit) {
+
+        double old_cost = sol->cost;
+        find_local_search(chain->ops[k])->run(inst, sol, timelimit - get_elapsed_time(t_start), print);
+
+        // The first local search is at its local optimum: after it the descent goes on
+        bool improved = (sol->cost < old_cost - EPSILON);
+        k = (improved && k > 0) ? 0 : k + 1;
+
+    }
+
+}
+
+// 2-opt over the candidate lists, with don't-look bits
+void two_opt_nl(const instance *inst, solution *sol, const double timelimit, bool print) {
+
+    if (inst->cand == NULL) {
+
+        if (inst->verbose >= LOW) printf("No candidate lists: using the full 2-opt\n");
+        two_opt(inst, sol, timelimit, print);
+        return;
+
+    }
+
+    double t_start = get_time_in_milliseconds();
+    bool is_asked_method = (strcmp(inst->asked_method, TWO_OPT) == 0);
+
+    int n = inst->nnodes;
+    double old_cost = sol->cost;
+    int moves = 0;
+
+    tour t;
+    tour_init(&t, sol, inst);
+
+    // Work queue of the nodes whose don't-look bit is off
+    work_queue q;
+    queue_init(&q, sol->visited_nodes, n);
+
+    while (q.count > 0 && get_elapsed_time(t_start) < timelimit) {
+
+        int a = queue_pop(&q);
+
+        const int *list = candidates(a, inst);
+        const cost_t *list_cost = candidate_costs(a, inst);
+
+        // Best move that adds an edge (a, c): dir 0 removes the edges after a and after c, dir 1 the ones before
+        double best_delta = -EPSILON;
+        int best_dir = -1, best_c = -1;
+
+        for (int dir = 0; dir < 2; dir++) {
+
+            int a2 = (dir == 0) ? tour_next(&t, a) : tour_prev(&t, a);
+            double cost_a = cost(a, a2, inst);
+
+            for (int k = 0; k < inst->cand_k; k++) {
+
+                // The lists are sorted: no later candidate can make the new edge shorter than the removed one
+                double cost_ac = (double) list_cost[k];
+                if (cost_ac >= cost_a) break;
+
+                int c = list[k];
+                int c2 = (dir == 0) ? tour_next(&t, c) : tour_prev(&t, c);
+                if (c == a2 || c2 == a) continue;
+
+                double delta = cost_ac + cost(a2, c2, inst) - cost_a - cost(c, c2, inst);
+
+                if (delta < best_delta) {
+
+                    best_delta = delta;
+                    best_dir = dir;
+                    best_c = c;
+
+                }
+
+            }
+
+        }
+
+        if (best_c < 0) continue;
+
+        // Apply the move and switch on the don't-look bits of its four nodes
+        int a2 = (best_dir == 0) ? tour_next(&t, a) : tour_prev(&t, a);
+        int c2 = (best_dir == 0) ? tour_next(&t, best_c) : tour_prev(&t, best_c);
+
+        tour_2opt_move(&t, a, a2, best_c, c2);
+
+        sol->cost += best_delta;
+        moves++;
+
+        queue_push(&q, a);
+        queue_push(&q, a2);
+        queue_push(&q, best_c);
+        queue_push(&q, c2);
+
+    }
+
+    queue_free(&q);
+    tour_to_solution(&t);
+    tour_free(&t);
+
+    // The deltas accumulate rounding errors: the cost is the one of the final tour
+    if (moves > 0) recompute_solution_cost(inst, sol);
+
+    if (print && moves > 0 && inst->verbose >= ONLY_INCUMBENT) {
+
+        printf(" * Old cost %10.6lf, New cost %10.6lf, Moves %d, Time %10.6lf\n", old_cost, sol->cost, moves, get_elapsed_time(t_start));
+
+    }
+
+    if (inst->verbose >= GOOD) {
+
+        check_sol(inst, sol);
+
+    }
+
+    if (moves > 0 && is_asked_method) {
+
+        strncpy_s(sol->method, METH_NAME_LEN, TWO_OPT, _TRUNCATE);
+
+    }
+
+}
+
+// Or-opt over the candidate lists, with don't-look bits
+void or_opt(const instance *inst, solution *sol, const double timelimit, bool print) {
+
+    int n = inst->nnodes;
+
+    // Small tours have no room for the segments
+    if (inst->cand == NULL || n < 2 * OR_OPT_MAX_SEGMENT + 2) return;
+
+    double t_start = get_time_in_milliseconds();
+    double old_cost = sol->cost;
+    int moves = 0;
+
+    tour t;
+    tour_init(&t, sol, inst);
+
+    work_queue q;
+    queue_init(&q, sol->visited_nodes, n);
+
+    while (q.count > 0 && get_elapsed_time(t_start) < timelimit) {
+
+        int a = queue_pop(&q);
+
+        const int *list = candidates(a, inst);
+        const cost_t *list_cost = candidate_costs(a, inst);
+
+        // Best move of a segment with end a: a -> e2 is the segment, o1 and o2 the nodes outside its ends,
+        // moved between c and c2 as c -> a ... e2 -> c2
+        double best_delta = -EPSILON;
+        int best_e2 = -1, best_o1 = -1, best_o2 = -1, best_c = -1, best_c2 = -1;
+        int segment[OR_OPT_MAX_SEGMENT];
+
+        for (int dir = 0; dir < 2; dir++) {
+
+            int o1 = (dir == 0) ? tour_prev(&t, a) : tour_next(&t, a);
+            int e2 = a;
+
+            for (int len = 1; len <= OR_OPT_MAX_SEGMENT; len++) {
+
+                if (len > 1) e2 = (dir == 0) ? tour_next(&t, e2) : tour_prev(&t, e2);
+                segment[len - 1] = e2;
+
+                int o2 = (dir == 0) ? tour_next(&t, e2) : tour_prev(&t, e2);
+
+                // Gain of taking the segment out of the tour
+                double removal_gain = cost(o1, a, inst) + cost(e2, o2, inst) - cost(o1, o2, inst);
+
+                for (int k = 0; k < inst->cand_k; k++) {
+
+                    // The lists are sorted: stop when the new edge at a costs all the gain of the removal
+                    double cost_ac = (double) list_cost[k];
+                    if (cost_ac >= removal_gain) break;
+
+                    int c = list[k];
+
+                    bool inside = false;
+                    for (int s = 0; s < len; s++) inside = inside || (segment[s] == c);
+                    if (inside) continue;
+
+                    // Both edges of c: the segment goes on the side of c2
+                    for (int side = 0; side < 2; side++) {
+
+                        int c2 = (side == 0) ? tour_next(&t, c) : tour_prev(&t, c);
+
+                        bool c2_inside = false;
+                        for (int s = 0; s < len; s++) c2_inside = c2_inside || (segment[s] == c2);
+                        if (c2_inside) continue;
+
+                        double delta = cost_ac + cost(e2, c2, inst) - cost(c, c2, inst) - removal_gain;
+
+                        if (delta < best_delta) {
+
+                            best_delta = delta;
+                            best_e2 = e2;
+                            best_o1 = o1;
+                            best_o2 = o2;
+                            best_c = c;
+                            best_c2 = c2;
+
+                        }
+
+                    }
+
+                }
+
+            }
+
+        }
+
+        if (best_c < 0) continue;
+
+        // The segment as a path forward from s1 to s2, the new position as the edge from c to d = next(c)
+        bool forward = (tour_next(&t, best_o1) == a);
+        int s1 = forward ? a : best_e2;
+        int s2 = forward ? best_e2 : a;
+
+        bool c_first = (tour_next(&t, best_c) == best_c2);
+        int c = c_first ? best_c : best_c2;
+        int d = c_first ? best_c2 : best_c;
+
+        // a goes next to best_c: the segment keeps its orientation if c is next to s1
+        int first = c_first ? a : best_e2;
+        tour_or_move(&t, s1, s2, c, d, first != s1);
+
+        sol->cost += best_delta;
+        moves++;
+
+        queue_push(&q, a);
+        queue_push(&q, best_e2);
+        queue_push(&q, best_o1);
+        queue_push(&q, best_o2);
+        queue_push(&q, best_c);
+        queue_push(&q, best_c2);
+
+    }
+
+    queue_free(&q);
+    tour_to_solution(&t);
+    tour_free(&t);
+
+    // The deltas accumulate rounding errors: the cost is the one of the final tour
+    if (moves > 0) recompute_solution_cost(inst, sol);
+
+    if (print && moves > 0 && inst->verbose >= ONLY_INCUMBENT) {
+
+        printf(" * Or-opt: Old cost %10.6lf, New cost %10.6lf, Moves %d, Time %10.6lf\n", old_cost, sol->cost, moves, get_elapsed_time(t_start));
+
+    }
+
+    if (inst->verbose >= GOOD) {
+
+        check_sol(inst, sol);
+
+    }
+
+}
+
+// 3-opt over the candidate lists, with don't-look bits
+void three_opt(const instance *inst, solution *sol, const double timelimit, bool print) {
+
+    if (inst->cand == NULL) {
+
+        if (inst->verbose >= LOW) printf("No candidate lists: using the full 2-opt\n");
+        two_opt(inst, sol, timelimit, print);
+        return;
+
+    }
+
+    double t_start = get_time_in_milliseconds();
+
+    int n = inst->nnodes;
+    double old_cost = sol->cost;
+    int moves = 0;
+
+    tour t;
+    tour_init(&t, sol, inst);
+
+    work_queue q;
+    queue_init(&q, sol->visited_nodes, n);
+
+    while (q.count > 0 && get_elapsed_time(t_start) < timelimit) {
+
+        int t1 = queue_pop(&q);
+
+        // Best move from t1: its nodes t1, ..., t6 (t5 = t6 = -1 for a 2-opt move)
+        double best_delta = -EPSILON;
+        int best[6] = {-1, -1, -1, -1, -1, -1};
+        int x[6];
+
+        x[0] = t1;
+
+        for (int dir = 0; dir < 2; dir++) {
+
+            int t2 = (dir == 0) ? tour_next(&t, t1) : tour_prev(&t, t1);
+            double g0 = cost(t1, t2, inst);
+            x[1] = t2;
+
+            const int *list2 = candidates(t2, inst);
+            const cost_t *list2_cost = candidate_costs(t2, inst);
+
+            for (int k2 = 0; k2 < inst->cand_k; k2++) {
+
+                // Gain criterion: the partial gain must stay positive
+                double g1 = g0 - (double) list2_cost[k2];
+                if (g1 <= EPSILON) break;
+
+                int t3 = list2[k2];
+                if (t3 == t1) continue;
+                x[2] = t3;
+
+                for (int side = 0; side < 2; side++) {
+
+                    int t4 = (side == 0) ? tour_next(&t, t3) : tour_prev(&t, t3);
+                    if (t4 == t2) continue;
+                    x[3] = t4;
+
+                    double g1_open = g1 + cost(t3, t4, inst);
+
+                    // Closing at t4 gives a 2-opt move when t4 is on the side of t3 opposite to the one of t2 from t1
+                    bool closes = (dir == 0) ? (side == 1) : (side == 0);
+
+                    if (closes && t4 != t1) {
+
+                        double delta = cost(t4, t1, inst) - g1_open;
+
+                        if (delta < best_delta) {
+
+                            best_delta = delta;
+                            for (int i = 0; i < 4; i++) best[i] = x[i];
+                            best[4] = best[5] = -1;
+
+                        }
+
+                    }
+
+                    const int *list4 = candidates(t4, inst);
+                    const cost_t *list4_cost = candidate_costs(t4, inst);
+
+                    for (int k4 = 0; k4 < inst->cand_k; k4++) {
+
+                        double g2 = g1_open - (double) list4_cost[k4];
+                        if (g2 <= EPSILON) break;
+
+                        int t5 = list4[k4];
+                        if (t5 == t3 || t5 == t2) continue;
+                        x[4] = t5;
+
+                        for (int side5 = 0; side5 < 2; side5++) {
+
+                            int t6 = (side5 == 0) ? tour_next(&t, t5) : tour_prev(&t, t5);
+                            if (t6 == t1 || t6 == t4) continue;
+
+                            // Only the improving moves are checked to give a tour
+                            double delta = cost(t6, t1, inst) - (g2 + cost(t5, t6, inst));
+                            if (delta >= best_delta) continue;
+
+                            x[5] = t6;
+
+                            int abc[3];
+                            if (tour_3opt_reconnection(&t, x, abc) == RECONNECT_INVALID) continue;
+
+                            best_delta = delta;
+                            for (int i = 0; i < 6; i++) best[i] = x[i];
+
+                        }
+
+                    }
+
+                }
+
+            }
+
+        }
+
+        if (best[0] < 0) continue;
+
+        // Apply the move and switch off the don't-look bits of its nodes
+        if (best[4] < 0) {
+
+            tour_2opt_move(&t, best[0], best[1], best[3], best[2]);
+
+        } else {
+
+            int abc[3];
+            Reconnection type = tour_3opt_reconnection(&t, best, abc);
+            tour_3opt_move(&t, abc[0], abc[1], abc[2], type);
+
+        }
+
+        sol->cost += best_delta;
+        moves++;
+
+        for (int i = 0; i < 6; i++) {
+
+            if (best[i] >= 0) queue_push(&q, best[i]);
+
+        }
+
+    }
+
+    queue_free(&q);
+    tour_to_solution(&t);
+    tour_free(&t);
+
+    // The deltas accumulate rounding errors: the cost is the one of the final tour
+    if (moves > 0) recompute_solution_cost(inst, sol);
+
+    if (print && moves > 0 && inst->verbose >= ONLY_INCUMBENT) {
+
+        printf(" * 3-opt: Old cost %10.6lf, New cost %10.6lf, Moves %d, Time %10.6lf\n", old_cost, sol->cost, moves, get_elapsed_time(t_start));
+
+    }
+
+    if (inst->verbose >= GOOD) {
+
+        check_sol(inst, sol);
+
+    }
+
+}
+
+// Parallel 2-opt over the candidate lists on sub-paths of the tour
+void two_opt_par(const instance *inst, solution *sol, const double timelimit, bool print) {
+
+    int n = inst->nnodes;
+    int nthreads = get_number_of_threads(inst);
+    if (nthreads > n / TWO_OPT_PAR_MIN_CHUNK) nthreads = n / TWO_OPT_PAR_MIN_CHUNK;
+
+    if (inst->cand == NULL || nthreads < 2) {
+
+        two_opt_nl(inst, sol, timelimit, print);
+        return;
+
+    }
+
+    double t_start = get_time_in_milliseconds();
+    double old_cost = sol->cost;
+    int *nodes = sol->visited_nodes;
+
+    int *pos = (int *) malloc(n * sizeof(int));
+    int *owner = (int *) malloc(n * sizeof(int));
+    bool *queued = (bool *) calloc(n, sizeof(bool));
+    bool *pending = (bool *) malloc(n * sizeof(bool));
+    two_opt_chunk_data *data = (two_opt_chunk_data *) malloc(nthreads * sizeof(two_opt_chunk_data));
+    HANDLE *threads = (HANDLE *) malloc(nthreads * sizeof(HANDLE));
+
+    if (pos == NULL || owner == NULL || queued == NULL || pending == NULL || data == NULL || threads == NULL) print_error("two_opt_par(): Cannot allocate memory");
+
+    // All the nodes are examined in the first round
+    for (int i = 0; i < n; i++) pending[i] = true;
+
+    // The Or-opt moves are applied in the sub-paths too when Or-opt is in the chain (e.g. -ls 2opt_par,oropt)
+    ls_chain chain;
+    build_local_search_chain(inst, &chain);
+
+    bool with_or_opt = false;
+    for (int k = 0; k < chain.len; k++) with_or_opt = with_or_opt || (chain.ops[k] == LS_OR_OPT);
+
+    int rounds = 0, moves = 0, round_moves = 1;
+
+    while (round_moves > 0 && rounds < TWO_OPT_PAR_MAX_ROUNDS && get_elapsed_time(t_start) < timelimit) {
+
+        // Move the boundaries: rotate the tour so that it starts from a random node
+        int offset = rand() % n;
+        reverse_segment(sol, 0, offset - 1);
+        reverse_segment(sol, offset, n - 1);
+        reverse_segment(sol, 0, n - 1);
+        nodes[n] = nodes[0];
+
+        // Sub-path t goes from position t*n/T to position (t+1)*n/T, its first node is its own
+        for (int t = 0; t < nthreads; t++) {
+
+            data[t].inst = inst;
+            data[t].nodes = nodes;
+            data[t].pos = pos;
+            data[t].owner = owner;
+            data[t].queued = queued;
+            data[t].pending = pending;
+            data[t].id = t;
+            data[t].first = (int) ((long long) n * t / nthreads);
+            data[t].last = (int) ((long long) n * (t + 1) / nthreads);
+            data[t].t_start = t_start;
+            data[t].timelimit = timelimit;
+            data[t].or_opt = with_or_opt;
+            data[t].moves = 0;
+
+            for (int p = data[t].first; p < data[t].last; p++) {
+
+                pos[nodes[p]] = p;
+                owner[nodes[p]] = t;
+
+            }
+
+        }
+
+        for (int t = 0; t < nthreads; t++) {
+
+            threads[t] = CreateThread(NULL, 0, two_opt_chunk_worker, &data[t], 0, NULL);
+            if (threads[t] == NULL) print_error("two_opt_par(): Cannot create thread");
+
+        }
+
+        WaitForMultipleObjects(nthreads, threads, TRUE, INFINITE);
+
+        round_moves = 0;
+
+        for (int t = 0; t < nthreads; t++) {
+
+            CloseHandle(threads[t]);
+            round_moves += data[t].moves;
+
+        }
+
+        moves += round_moves;
+        rounds++;
+
+    }
+
+    free(threads);
+    free(data);
+    free(pending);
+    free(queued);
+    free(owner);
+    free(pos);
+
+    // The rotations moved the tour too
+    if (rounds > 0) recompute_solution_cost(inst, sol);
+
+    double parallel_time = get_elapsed_time(t_start);
+    double parallel_cost = sol->cost;
+
+    // The moves across the sub-paths
+    two_opt_nl(inst, sol, timelimit - parallel_time, false);
+
+    if (print && inst->verbose >= LOW) {
+
+        printf("Parallel 2-opt%s: %d threads, %d rounds, %d moves in %lf seconds (cost %10.6lf), then sequential 2-opt in %lf seconds\n", 
+            with_or_opt ? " and Or-opt" : "", nthreads, rounds, moves, parallel_time, parallel_cost, get_elapsed_time(t_start) - parallel_time);
+
+    }
+
+    if (print && sol->cost < old_cost - EPSILON && inst->verbose >= ONLY_INCUMBENT) {
+
+        printf(" * Old cost %10.6lf, New cost %10.6lf, Time %10.6lf\n", old_cost, sol->cost, get_elapsed_time(t_start));
+
+    }
+
+}
+
+// 2-opt over the candidate lists on the sub-path of a thread
+DWORD WINAPI two_opt_chunk_worker(LPVOID param) {
+
+    two_opt_chunk_data *data = (two_opt_chunk_data *) param;
+    const instance *inst = data->inst;
+    int *nodes = data->nodes;
+    int *pos = data->pos;
+    bool *queued = data->queued;
+    bool *pending = data->pending;
+
+    // The removed edges are (e, e+1) for first <= e < last, the nodes of the thread are the ones before last
+    int first = data->first;
+    int last = data->last;
+
+    // Work queue of the nodes of the thread whose don't-look bit is off: the ones left pending by the previous rounds
+    int capacity = last - first;
+    int *ring = (int *) malloc(capacity * sizeof(int));
+    if (ring == NULL) print_error("two_opt_chunk_worker(): Cannot allocate memory");
+
+    int head = 0, count = 0;
+
+    for (int p = first; p < last; p++) {
+
+        if (!pending[nodes[p]]) continue;
+
+        ring[count++] = nodes[p];
+        queued[nodes[p]] = true;
+        pending[nodes[p]] = false;
+
+    }
+
+    while (count > 0 && get_elapsed_time(data->t_start) < data->timelimit) {
+
+        int a = ring[head];
+        if (++head == capacity) head = 0;
+        count--;
+        queued[a] = false;
+
+        int p = pos[a];
+
+        const int *list = candidates(a, inst);
+        const cost_t *list_cost = candidate_costs(a, inst);
+
+        // Best move that adds an edge (a, c): dir 0 removes the edges after a and after c, dir 1 the ones before
+        double best_delta = -EPSILON;
+        int best_e1 = -1, best_e2 = -1;
+
+        for (int dir = 0; dir < 2; dir++) {
+
+            int e1 = (dir == 0) ? p : p - 1;
+            if (e1 < first || e1 >= last) continue;
+
+            int a2 = (dir == 0) ? nodes[p + 1] : nodes[p - 1];
+            double cost_a = cost(a, a2, inst);
+
+            for (int k = 0; k < inst->cand_k; k++) {
+
+                // The lists are sorted: no later candidate can make the new edge shorter than the removed one
+                double cost_ac = (double) list_cost[k];
+                if (cost_ac >= cost_a) break;
+
+                // Only the candidates of the sub-path, whose positions are written by this thread:
+                // a is left pending for the next rounds, when the boundaries are elsewhere
+                int c = list[k];
+                if (data->owner[c] != data->id) { pending[a] = true; continue; }
+
+                int q = pos[c];
+                int e2 = (dir == 0) ? q : q - 1;
+                if (e2 < first || e2 >= last || e2 == e1) continue;
+
+                int c2 = (dir == 0) ? nodes[q + 1] : nodes[q - 1];
+                if (c == a2 || c2 == a) continue;
+
+                double delta = cost_ac + cost(a2, c2, inst) - cost_a - cost(c, c2, inst);
+
+                if (delta < best_delta) {
+
+                    best_delta = delta;
+                    best_e1 = e1;
+                    best_e2 = e2;
+
+                }
+
+            }
+
+        }
+
+        // Or-opt moves of the segments with end a, if asked: the best of the two neighbourhoods is applied
+        int best_s = -1, best_e = -1, best_x = -1;
+        bool best_reversed = false;
+
+        if (data->or_opt) {
+
+            for (int len = 1; len <= OR_OPT_MAX_SEGMENT; len++) {
+
+                for (int dir = 0; dir < 2; dir++) {
+
+                    // The segment from position s to position e, a is its first node (dir 0) or its last one (dir 1)
+                    int s = (dir == 0) ? p : p - len + 1;
+                    int e = (dir == 0) ? p + len - 1 : p;
+                    if (s - 1 < first || e >= last || (len == 1 && dir == 1)) continue;
+
+                    // Gain of taking the segment out of the tour
+                    double removal_gain = cost(nodes[s - 1], nodes[s], inst) + cost(nodes[e], nodes[e + 1], inst) -
+                                          cost(nodes[s - 1], nodes[e + 1], inst);
+
+                    for (int k = 0; k < inst->cand_k; k++) {
+
+                        // The lists are sorted: stop when the new edge at a costs all the gain of the removal
+                        double cost_ac = (double) list_cost[k];
+                        if (cost_ac >= removal_gain) break;
+
+                        int c = list[k];
+                        if (data->owner[c] != data->id) { pending[a] = true; continue; }
+
+                        // The segment goes in the edge (x, x+1) of the sub-path before or after c, outside the segment
+                        for (int side = 0; side < 2; side++) {
+
+                            int x = (side == 0) ? pos[c] : pos[c] - 1;
+                            if (x < first || x >= last || (x >= s - 1 && x <= e)) continue;
+
+                            // a is next to c: the segment goes in as c -> a ... or ... a -> c
+                            int other = (dir == 0) ? nodes[e] : nodes[s];
+                            int left = nodes[x], right = nodes[x + 1];
+                            int in_first = (side == 0) ? a : other;
+                            int in_last = (side == 0) ? other : a;
+
+                            double delta = cost(left, in_first, inst) + cost(in_last, right, inst) - cost(left, right, inst) - removal_gain;
+
+                            if (delta < best_delta) {
+
+                                best_delta = delta;
+                                best_e1 = -1;
+                                best_s = s;
+                                best_e = e;
+                                best_x = x;
+                                best_reversed = (len > 1 && in_first == nodes[e]);
+
+                            }
+
+                        }
+
+                    }
+
+                }
+
+            }
+
+        }
+
+        if (best_e1 < 0 && best_s < 0) continue;
+
+        int touched[6];
+        int ntouched;
+
+        if (best_e1 >= 0) {
+
+            // The four nodes of the removed edges
+            int lo = (best_e1 < best_e2) ? best_e1 : best_e2;
+            int hi = (best_e1 < best_e2) ? best_e2 : best_e1;
+            touched[0] = nodes[lo];
+            touched[1] = nodes[lo + 1];
+            touched[2] = nodes[hi];
+            touched[3] = nodes[hi + 1];
+            ntouched = 4;
+
+            // Reverse the nodes between the two removed edges, strictly inside the sub-path
+            reverse_positions(nodes, pos, lo + 1, hi);
+
+        } else {
+
+            // The six nodes of the removed edges
+            touched[0] = nodes[best_s - 1];
+            touched[1] = nodes[best_s];
+            touched[2] = nodes[best_e];
+            touched[3] = nodes[best_e + 1];
+            touched[4] = nodes[best_x];
+            touched[5] = nodes[best_x + 1];
+            ntouched = 6;
+
+            // Move the segment with reversals, strictly inside the sub-path: the nodes between the segment and the edge
+            // are reversed with it, then put back in their orientation
+            int len = best_e - best_s + 1;
+
+            if (best_x > best_e) {
+
+                // s-1 -> S -> M -> x+1 becomes s-1 -> M -> S -> x+1
+                reverse_positions(nodes, pos, best_s, best_x);
+                reverse_positions(nodes, pos, best_s, best_x - len);
+                if (!best_reversed) reverse_positions(nodes, pos, best_x - len + 1, best_x);
+
+            } else {
+
+                // x -> M -> S -> e+1 becomes x -> S -> M -> e+1
+                reverse_positions(nodes, pos, best_x + 1, best_e);
+                reverse_positions(nodes, pos, best_x + 1 + len, best_e);
+                if (!best_reversed) reverse_positions(nodes, pos, best_x + 1, best_x + len);
+
+            }
+
+        }
+
+        data->moves++;
+
+        // Switch on the don't-look bits of the nodes of the thread among the ones of the removed edges
+        for (int s = 0; s < ntouched; s++) {
+
+            int node = touched[s];
+            if (data->owner[node] != data->id || pos[node] >= last || queued[node]) continue;
+
+            int tail = head + count;
+            if (tail >= capacity) tail -= capacity;
+
+            ring[tail] = node;
+            queued[node] = true;
+            count++;
+
+        }
+
+    }
+
+    // The nodes left in the queue at the time limit stay pending
+    for (; count > 0; count--) {
+
+        queued[ring[head]] = false;
+        pending[ring[head]] = true;
+        if (++head == capacity) head = 0;
+
+    }
+
+    free(ring);
+
+    return 0;
+
+}
+
+// Reverse the nodes of the tour from position i to position j
+void reverse_positions(int *nodes, int *pos, const int i, const int j) {
+
+    for (int l = i, r = j; l < r; l++, r--) {
+
+        int temp = nodes[l];
+        nodes[l] = nodes[r];
+        nodes[r] = temp;
+
+        pos[nodes[l]] = l;
+        pos[nodes[r]] = r;
+
+    }
+
+}
+
+// Check if the local searches asked use the candidate lists
+bool local_search_needs_candidates(const instance *inst) {
+
+    ls_chain chain;
+    build_local_search_chain(inst, &chain);
+
+    bool needs = strcmp(inst->asked_method, LIN_KERNIGHAN) == 0;
+
+    for (int k = 0; k < chain.len; k++) {
+
+        needs = needs || find_local_search(chain.ops[k])->needs_candidates;
+
+    }
+
+    return needs;
+
+}
+
+// Find a local search in the registry
+const ls_operator *find_local_search(const LocalSearchType type) {
+
+    for (int l = 0; l < LS_REGISTRY_SIZE; l++) {
+
+        if (LS_REGISTRY[l].type == type) return &LS_REGISTRY[l];
+
+    }
+
+    return &LS_REGISTRY[0];
+
+}
+
+// Return the name of a local search
+const char *local_search_name(const LocalSearchType type) {
+
+    return find_local_search(type)->name;
+
+}
+
+// Read the name of a local search
+bool parse_local_search(const char *name, LocalSearchType *type) {
+
+    for (int l = 0; l < LS_REGISTRY_SIZE; l++) {
+
+        if (strcmp(name, LS_REGISTRY[l].name) == 0) {
+
+            *type = LS_REGISTRY[l].type;
+            return true;
+
+        }
+
+    }
+
+    return false;
+
+}
+
+// Read a chain of local searches separated by commas
+bool parse_local_search_chain(const char *spec, ls_chain *chain) {
+
+    char name[LS_CHAIN_NAME_LEN];
+    int len = 0;
+
+    while (true) {
+
+        const char *comma = strchr(spec, ',');
+        size_t name_len = (comma != NULL) ? (size_t) (comma - spec) : strlen(spec);
+
+        if (len == LS_MAX_CHAIN || name_len == 0 || name_len >= LS_CHAIN_NAME_LEN) return false;
+
+        memcpy(name, spec, name_len);
+        name[name_len] = EMPTY_STRING;
+
+        if (!parse_local_search(name, &chain->ops[len])) return false;
+        len++;
+
+        if (comma == NULL) break;
+        spec = comma + 1;
+
+    }
+
+    chain->len = len;
+    return true;
+
+}
+
+// Write the name of a chain of local searches
+void local_search_chain_name(const ls_chain *chain, char *name, const int size) {
+
+    int written = 0;
+    name[0] = EMPTY_STRING;
+
+    for (int k = 0; k < chain->len && written < size; k++) {
+
+        written += sprintf_s(name + written, size - written, (k == 0) ? "%s" : ",%s", local_search_name(chain->ops[k]));
+
+    }
+
+}
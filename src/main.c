@@ -21,6 +21,9 @@ int main(int argc, const char *argv[]) {
     // Compute the solution
     solve_with_method(&inst, inst.best_solution); 
 
+    // Back to the original ids of the nodes, if they were renumbered
+    restore_node_numbering(&inst, inst.best_solution);
+
     if (inst.verbose >= DEBUG_V) {
 
         // Print solution
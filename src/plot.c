@@ -117,6 +117,9 @@ void plot_stats_in_file_base(const char* filename) {
 // Plot the subtours in the Gnuplot file
 void plot_subtours(const instance *inst, const int **subtours, const int *subtour_lengths, const int nsubtours, const int iter) {
     
+    // Nothing to draw without coordinates
+    if (inst->coord == NULL) return;
+
     FILE *gnuplot = open_plot();
 
     char filename[FILE_NAME_LEN];
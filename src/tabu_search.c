@@ -10,8 +10,11 @@ void tabu_search(const instance *inst, solution *sol, const double timelimit) {
     solution temp_sol;
     copy_sol(&temp_sol, sol, inst->nnodes);
 
+    // The 2-opt moves read the removed edges from the cache
+    cache_edge_costs(inst, &temp_sol);
+
     // Go to local minima, for first iterations the tabu list is useless
-    two_opt(inst, &temp_sol, timelimit, false);
+    local_search(inst, &temp_sol, timelimit, false);
     bool u = update_sol(inst, sol, &temp_sol, is_asked_method);
     updated = updated || u;
         
@@ -34,7 +37,11 @@ void tabu_search(const instance *inst, solution *sol, const double timelimit) {
 
     }
 
+    two_opt_scan scan;
+    two_opt_scan_init(&scan, inst);
+
     double residual_time;
+    double t_tabu = get_time_in_milliseconds();
 
     // Main loop
     while ((residual_time = timelimit - get_elapsed_time(t_start)) > 0) {
@@ -42,7 +49,7 @@ void tabu_search(const instance *inst, solution *sol, const double timelimit) {
         reset_tabu_list_if_full(&params, inst);
 
         // Find best neighbor
-        move_to_best_neighbor(inst, &temp_sol, &params);
+        move_to_best_neighbor(inst, &temp_sol, &params, &scan);
 
         if (inst->verbose >= GOOD) {
 
@@ -72,6 +79,16 @@ void tabu_search(const instance *inst, solution *sol, const double timelimit) {
         
     }
 
+    if (inst->verbose >= LOW) {
+
+        double tabu_time = get_elapsed_time(t_tabu);
+        printf("Tabu search: %.1lf iterations per second (%d iterations in %lf seconds)\n", 
+            (tabu_time > 0.0) ? params.current_iter / tabu_time : 0.0, params.current_iter, tabu_time);
+        printf("Tabu search: %.0lf moves evaluated per second (%s scan)\n", 
+            (tabu_time > 0.0) ? scan.moves / tabu_time : 0.0, scan.vectorized ? SIMD_NAME : "scalar");
+
+    }
+
     if (updated) {
 
         sprintf_s(sol->method, METH_NAME_LEN, filename);
@@ -92,6 +109,7 @@ void tabu_search(const instance *inst, solution *sol, const double timelimit) {
     }
 
     // Free memory
+    two_opt_scan_free(&scan);
     free_tabu_params(&params);
 
 }
@@ -236,37 +254,43 @@ void reset_tabu_list_if_full(tabu_params *params, const instance *inst) {
 }
 
 // Find best neighbor using considering tabu status and move to it
-void move_to_best_neighbor(const instance *inst, solution *current, tabu_params *params) {
+void move_to_best_neighbor(const instance *inst, solution *current, tabu_params *params, two_opt_scan *scan) {
     
     int nnodes = inst->nnodes;
     double best_delta = DBL_MAX;
     int best_i = -1, best_j = -1;
 
-    // Try all possible 2-opt swaps
+    two_opt_scan_load(scan, inst, current);
+
+    // Try all possible 2-opt swaps, one row of moves (i, i+1..n-1) at a time
     for (int i = 1; i < nnodes - 1; i++) {
 
-        for (int j = i + 1; j < nnodes; j++) {
+        int count = nnodes - 1 - i;
+        double *delta = two_opt_scan_row(scan, inst, i, i + 1, nnodes - 1);
 
-            // Skip if the edge is tabu
-            if (is_tabu(params, current->visited_nodes[i]) &&
-                is_tabu(params, current->visited_nodes[j])) {
+        // Skip the moves where both nodes are tabu
+        if (is_tabu(params, current->visited_nodes[i])) {
 
-                continue;
+            for (int k = 0; k < count; k++) {
+
+                if (is_tabu(params, current->visited_nodes[i + 1 + k])) delta[k] = INFINITY;
 
             }
 
-            // Compute the delta cost
-            double delta = delta2(inst, current, i, j);
+        }
 
-            // If current delta is better update it
-            if (delta < best_delta - EPSILON) {
+        double row_best = min_delta(delta, count);
 
-                best_delta = delta;
-                best_i = i;
-                best_j = j;
+        // If current delta is better update it
+        if (row_best < best_delta - EPSILON) {
+
+            int k = 0;
+            while (delta[k] != row_best) k++;
+
+            best_delta = row_best;
+            best_i = i;
+            best_j = i + 1 + k;
 
-            }
-            
         }
 
     }
@@ -275,7 +299,7 @@ void move_to_best_neighbor(const instance *inst, solution *current, tabu_params
     if (best_i != -1 && best_j != -1) {
 
         current->cost += best_delta;
-        reverse_segment(current, best_i, best_j);
+        apply_two_opt_move(inst, current, best_i, best_j);
 
         // Mark as tabu the edges
         update_tabu_status(params, current->visited_nodes[best_i-1]);
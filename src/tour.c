@@ -0,0 +1,723 @@
+#include "tour.h"
+
+// Initialize a tour on the visited nodes of a solution
+void tour_init(tour *t, solution *sol, const instance *inst) {
+
+    int n = inst->nnodes;
+
+    t->n = n;
+    t->nodes = sol->visited_nodes;
+    t->nodes[n] = t->nodes[0];
+    t->two_level = (inst->two_level_min > 0 && n >= inst->two_level_min);
+    t->log = NULL;
+    t->log_len = 0;
+    t->log_capacity = 0;
+
+    if (!t->two_level) {
+
+        t->pos = (int *) malloc(n * sizeof(int));
+        if (t->pos == NULL) print_error("tour_init(): Cannot allocate memory");
+
+        for (int p = 0; p < n; p++) t->pos[t->nodes[p]] = p;
+
+        return;
+
+    }
+
+    t->pos = NULL;
+    t->group_size = (int) sqrt((double) n);
+    if (t->group_size < 1) t->group_size = 1;
+    t->nsegments = (n + t->group_size - 1) / t->group_size;
+
+    int m = t->nsegments;
+
+    t->link_prev = (int *) malloc(n * sizeof(int));
+    t->link_next = (int *) malloc(n * sizeof(int));
+    t->seg = (int *) malloc(n * sizeof(int));
+    t->id = (int *) malloc(n * sizeof(int));
+    t->seg_first = (int *) malloc(m * sizeof(int));
+    t->seg_last = (int *) malloc(m * sizeof(int));
+    t->seg_size = (int *) malloc(m * sizeof(int));
+    t->seg_reversed = (bool *) malloc(m * sizeof(bool));
+    t->seg_prev = (int *) malloc(m * sizeof(int));
+    t->seg_next = (int *) malloc(m * sizeof(int));
+    t->seg_rank = (int *) malloc(m * sizeof(int));
+    t->run = (int *) malloc(m * sizeof(int));
+
+    if (t->link_prev == NULL || t->link_next == NULL || t->seg == NULL || t->id == NULL ||
+        t->seg_first == NULL || t->seg_last == NULL || t->seg_size == NULL || t->seg_reversed == NULL ||
+        t->seg_prev == NULL || t->seg_next == NULL || t->seg_rank == NULL || t->run == NULL) {
+
+        print_error("tour_init(): Cannot allocate memory");
+
+    }
+
+    two_level_build(t, t->nodes);
+
+}
+
+// Start keeping the log of the moves applied to the tour
+void tour_start_log(tour *t) {
+
+    t->log_capacity = (t->n > 64) ? t->n : 64;
+    t->log_len = 0;
+
+    t->log = (int *) malloc(4 * t->log_capacity * sizeof(int));
+    if (t->log == NULL) print_error("tour_start_log(): Cannot allocate memory");
+
+}
+
+// Undo the moves of the log after the first mark ones
+void tour_undo(tour *t, const int mark) {
+
+    int *log = t->log;
+
+    // Stop logging while undoing
+    t->log = NULL;
+
+    for (int m = t->log_len - 1; m >= mark; m--) {
+
+        // (a, b), (c, d) became (a, c), (b, d): the inverse is the 2-opt move on (a, c), (b, d)
+        int *move = &log[4 * m];
+        tour_2opt_move(t, move[0], move[2], move[1], move[3]);
+
+    }
+
+    t->log = log;
+    t->log_len = mark;
+
+}
+
+// Write the tour in the visited nodes of the solution
+void tour_to_solution(const tour *t) {
+
+    if (!t->two_level) return;
+
+    int node = segment_head(t, 0);
+
+    for (int p = 0; p < t->n; p++) {
+
+        t->nodes[p] = node;
+        node = tour_next(t, node);
+
+    }
+
+    t->nodes[t->n] = t->nodes[0];
+
+}
+
+// Free the memory of a tour
+void tour_free(tour *t) {
+
+    if (t->two_level) {
+
+        free(t->link_prev);
+        free(t->link_next);
+        free(t->seg);
+        free(t->id);
+        free(t->seg_first);
+        free(t->seg_last);
+        free(t->seg_size);
+        free(t->seg_reversed);
+        free(t->seg_prev);
+        free(t->seg_next);
+        free(t->seg_rank);
+        free(t->run);
+
+    }
+
+    free(t->pos);
+    free(t->log);
+    t->pos = NULL;
+    t->log = NULL;
+    t->nodes = NULL;
+
+}
+
+// Build the two-level list of a tour from the order of its nodes
+void two_level_build(tour *t, const int *order) {
+
+    int n = t->n;
+    int m = t->nsegments;
+
+    for (int s = 0; s < m; s++) {
+
+        int first = s * t->group_size;
+        int last = (s == m - 1) ? n - 1 : first + t->group_size - 1;
+
+        t->seg_first[s] = order[first];
+        t->seg_last[s] = order[last];
+        t->seg_size[s] = last - first + 1;
+        t->seg_reversed[s] = false;
+        t->seg_prev[s] = (s == 0) ? m - 1 : s - 1;
+        t->seg_next[s] = (s == m - 1) ? 0 : s + 1;
+        t->seg_rank[s] = s;
+
+        for (int p = first; p <= last; p++) {
+
+            int node = order[p];
+
+            t->seg[node] = s;
+            t->id[node] = p - first;
+            t->link_prev[node] = (p > first) ? order[p - 1] : -1;
+            t->link_next[node] = (p < last) ? order[p + 1] : -1;
+
+        }
+
+    }
+
+}
+
+// Reverse the path of the tour from node a forward to node b
+void tour_reverse(tour *t, const int a, const int b) {
+
+    if (t->two_level) {
+
+        two_level_reverse(t, a, b);
+        return;
+
+    }
+
+    int n = t->n;
+    int i = t->pos[a];
+    int j = t->pos[b];
+
+    // Number of nodes of the path, going forward from a to b
+    int len = j - i + 1;
+    if (len <= 0) len += n;
+
+    // Reverse the shorter side: the path from next(b) to prev(a)
+    if (2 * len > n) {
+
+        i = (j + 1 < n) ? j + 1 : 0;
+        j = (t->pos[a] > 0) ? t->pos[a] - 1 : n - 1;
+        len = n - len;
+
+    }
+
+    // Swap the nodes from the two ends, wrapping around the end of the array
+    for (int k = 0; k < len / 2; k++) {
+
+        int u = t->nodes[i];
+        int v = t->nodes[j];
+
+        t->nodes[i] = v;
+        t->pos[v] = i;
+        t->nodes[j] = u;
+        t->pos[u] = j;
+
+        if (++i == n) i = 0;
+        if (--j < 0) j = n - 1;
+
+    }
+
+    // Keep the closing node
+    t->nodes[n] = t->nodes[0];
+
+}
+
+// Reverse the path of a two-level list from node a forward to node b
+void two_level_reverse(tour *t, const int a, const int b) {
+
+    if (a == b || tour_next(t, b) == a) return;
+
+    int n = t->n;
+    int sa = t->seg[a];
+    int sb = t->seg[b];
+
+    // Number of nodes of the path: the ends in their segments and the segments in between
+    int len;
+
+    if (sa == sb && two_level_key(t, a) <= two_level_key(t, b)) {
+
+        len = abs(t->id[b] - t->id[a]) + 1;
+
+    } else {
+
+        len = (t->seg_reversed[sa] ? t->id[a] - t->id[t->seg_first[sa]] : t->id[t->seg_last[sa]] - t->id[a]) + 1;
+        len += (t->seg_reversed[sb] ? t->id[t->seg_last[sb]] - t->id[b] : t->id[b] - t->id[t->seg_first[sb]]) + 1;
+
+        for (int s = t->seg_next[sa]; s != sb; s = t->seg_next[s]) len += t->seg_size[s];
+
+    }
+
+    // Reverse the shorter side: the path from next(b) to prev(a)
+    int from = a, to = b;
+
+    if (2 * len > n) {
+
+        from = tour_next(t, b);
+        to = tour_prev(t, a);
+
+    }
+
+    // A path inside a segment, not the whole segment, is relinked
+    int s = t->seg[from];
+
+    if (s == t->seg[to] && two_level_key(t, from) <= two_level_key(t, to) &&
+        (from != segment_head(t, s) || to != segment_tail(t, s))) {
+
+        two_level_reverse_inside(t, from, to);
+        return;
+
+    }
+
+    // Split the path from the rest of the tour: from must be the first node of its segment ...
+    if (from != segment_head(t, s)) {
+
+        int size_to_tail = (t->seg_reversed[s] ? t->id[from] - t->id[t->seg_first[s]] : t->id[t->seg_last[s]] - t->id[from]) + 1;
+
+        if (t->seg_size[s] - size_to_tail <= size_to_tail) two_level_move_to_prev(t, tour_prev(t, from));
+        else two_level_move_to_next(t, from);
+
+    }
+
+    // ... (the path may now be inside a segment) ...
+    s = t->seg[from];
+
+    if (s == t->seg[to] && to != segment_tail(t, s)) {
+
+        two_level_reverse_inside(t, from, to);
+        return;
+
+    }
+
+    // ... and to the last node of its segment, without moving nodes before from
+    s = t->seg[to];
+
+    if (to != segment_tail(t, s)) {
+
+        int size_from_head = (t->seg_reversed[s] ? t->id[t->seg_last[s]] - t->id[to] : t->id[to] - t->id[t->seg_first[s]]) + 1;
+
+        if (t->seg_size[s] - size_from_head < size_from_head && t->seg_next[s] != t->seg[from]) two_level_move_to_next(t, tour_next(t, to));
+        else two_level_move_to_prev(t, to);
+
+    }
+
+    two_level_reverse_segments(t, t->seg[from], t->seg[to]);
+
+    // Rebuild the segments if one has grown too much
+    int max_size = TWO_LEVEL_MAX_GROWTH * t->group_size;
+
+    if (t->seg_size[t->seg[from]] > max_size || t->seg_size[t->seg[to]] > max_size ||
+        t->seg_size[t->seg_prev[t->seg[to]]] > max_size || t->seg_size[t->seg_next[t->seg[from]]] > max_size) {
+
+        tour_to_solution(t);
+        two_level_build(t, t->nodes);
+
+    }
+
+}
+
+// Reverse the path from node a forward to node b inside a segment of a two-level list
+void two_level_reverse_inside(tour *t, const int a, const int b) {
+
+    int s = t->seg[a];
+
+    // The path in the orientation of the segment, from u to v
+    int u = t->seg_reversed[s] ? b : a;
+    int v = t->seg_reversed[s] ? a : b;
+
+    int before = (u == t->seg_first[s]) ? -1 : t->link_prev[u];
+    int after = (v == t->seg_last[s]) ? -1 : t->link_next[v];
+    int id_sum = t->id[u] + t->id[v];
+
+    // Swap the links of each node of the path, keeping the sequence numbers in the same range
+    int node = u;
+
+    while (true) {
+
+        int next = t->link_next[node];
+
+        t->link_next[node] = t->link_prev[node];
+        t->link_prev[node] = next;
+        t->id[node] = id_sum - t->id[node];
+
+        if (node == v) break;
+        node = next;
+
+    }
+
+    // Link the ends of the path to the rest of the segment
+    t->link_prev[v] = before;
+    t->link_next[u] = after;
+
+    if (before >= 0) t->link_next[before] = v;
+    else t->seg_first[s] = v;
+
+    if (after >= 0) t->link_prev[after] = u;
+    else t->seg_last[s] = u;
+
+}
+
+// Reverse the segments of a two-level list from segment sa forward to segment sb
+void two_level_reverse_segments(tour *t, const int sa, const int sb) {
+
+    int k = 0;
+
+    for (int s = sa; ; s = t->seg_next[s]) {
+
+        t->run[k++] = s;
+        if (s == sb) break;
+
+    }
+
+    int before = t->seg_prev[sa];
+    int after = t->seg_next[sb];
+
+    // The ranks stay with the places in the tour
+    for (int i = 0; i < k / 2; i++) {
+
+        int r = t->seg_rank[t->run[i]];
+        t->seg_rank[t->run[i]] = t->seg_rank[t->run[k - 1 - i]];
+        t->seg_rank[t->run[k - 1 - i]] = r;
+
+    }
+
+    // New order: before, sb, ..., sa, after
+    for (int i = 0; i < k; i++) {
+
+        int s = t->run[i];
+
+        t->seg_reversed[s] = !t->seg_reversed[s];
+        t->seg_next[s] = (i == 0) ? after : t->run[i - 1];
+        t->seg_prev[s] = (i == k - 1) ? before : t->run[i + 1];
+
+    }
+
+    t->seg_next[before] = sb;
+    t->seg_prev[after] = sa;
+
+}
+
+// Move the nodes of a segment from its first node in the tour to node x at the end of the segment before it
+void two_level_move_to_prev(tour *t, const int x) {
+
+    int s = t->seg[x];
+    int target = t->seg_prev[s];
+    int node;
+
+    do {
+
+        // Take the first node of s in the tour ...
+        if (!t->seg_reversed[s]) {
+
+            node = t->seg_first[s];
+            t->seg_first[s] = t->link_next[node];
+
+        } else {
+
+            node = t->seg_last[s];
+            t->seg_last[s] = t->link_prev[node];
+
+        }
+
+        // ... and append it to target in the tour
+        if (!t->seg_reversed[target]) {
+
+            int last = t->seg_last[target];
+            t->link_next[last] = node;
+            t->link_prev[node] = last;
+            t->link_next[node] = -1;
+            t->id[node] = t->id[last] + 1;
+            t->seg_last[target] = node;
+
+        } else {
+
+            int first = t->seg_first[target];
+            t->link_prev[first] = node;
+            t->link_next[node] = first;
+            t->link_prev[node] = -1;
+            t->id[node] = t->id[first] - 1;
+            t->seg_first[target] = node;
+
+        }
+
+        t->seg[node] = target;
+        t->seg_size[s]--;
+        t->seg_size[target]++;
+
+    } while (node != x);
+
+    if (t->id[t->seg_first[target]] < -TWO_LEVEL_ID_BOUND || t->id[t->seg_last[target]] > TWO_LEVEL_ID_BOUND) two_level_renumber(t, target);
+
+}
+
+// Move the nodes of a segment from node x to its last node in the tour at the beginning of the segment after it
+void two_level_move_to_next(tour *t, const int x) {
+
+    int s = t->seg[x];
+    int target = t->seg_next[s];
+    int node;
+
+    do {
+
+        // Take the last node of s in the tour ...
+        if (!t->seg_reversed[s]) {
+
+            node = t->seg_last[s];
+            t->seg_last[s] = t->link_prev[node];
+
+        } else {
+
+            node = t->seg_first[s];
+            t->seg_first[s] = t->link_next[node];
+
+        }
+
+        // ... and prepend it to target in the tour
+        if (!t->seg_reversed[target]) {
+
+            int first = t->seg_first[target];
+            t->link_prev[first] = node;
+            t->link_next[node] = first;
+            t->link_prev[node] = -1;
+            t->id[node] = t->id[first] - 1;
+            t->seg_first[target] = node;
+
+        } else {
+
+            int last = t->seg_last[target];
+            t->link_next[last] = node;
+            t->link_prev[node] = last;
+            t->link_next[node] = -1;
+            t->id[node] = t->id[last] + 1;
+            t->seg_last[target] = node;
+
+        }
+
+        t->seg[node] = target;
+        t->seg_size[s]--;
+        t->seg_size[target]++;
+
+    } while (node != x);
+
+    if (t->id[t->seg_first[target]] < -TWO_LEVEL_ID_BOUND || t->id[t->seg_last[target]] > TWO_LEVEL_ID_BOUND) two_level_renumber(t, target);
+
+}
+
+// Renumber the nodes of a segment of a two-level list from 0
+void two_level_renumber(tour *t, const int s) {
+
+    int id = 0;
+
+    for (int node = t->seg_first[s]; ; node = t->link_next[node]) {
+
+        t->id[node] = id++;
+        if (node == t->seg_last[s]) break;
+
+    }
+
+}
+
+// Apply a 2-opt move
+void tour_2opt_move(tour *t, const int a, const int b, const int c, const int d) {
+
+    // a -> b ... c -> d becomes a -> c ... b -> d, and b -> a ... d -> c becomes b -> d ... a -> c
+    if (tour_next(t, a) == b) tour_reverse(t, b, c);
+    else tour_reverse(t, a, d);
+
+    if (t->log != NULL) {
+
+        if (t->log_len == t->log_capacity) {
+
+            t->log_capacity *= 2;
+            int *log = (int *) realloc(t->log, 4 * t->log_capacity * sizeof(int));
+            if (log == NULL) print_error("tour_2opt_move(): Cannot allocate memory");
+            t->log = log;
+
+        }
+
+        int *move = &t->log[4 * t->log_len++];
+        move[0] = a;
+        move[1] = b;
+        move[2] = c;
+        move[3] = d;
+
+    }
+
+}
+
+// Apply an Or-opt move
+void tour_or_move(tour *t, const int s1, const int s2, const int c, const int d, const bool reversed) {
+
+    int p = tour_prev(t, s1);
+    int nx = tour_next(t, s2);
+
+    // p -> s1 ... s2 -> nx ... c -> d becomes p -> c ... nx -> s2 ... s1 -> d
+    tour_2opt_move(t, p, s1, c, d);
+
+    // then p -> nx ... c -> s2 ... s1 -> d: the path is between c and d, reversed
+    tour_2opt_move(t, p, c, nx, s2);
+
+    // and, if asked, back to its orientation: c -> s1 ... s2 -> d
+    if (!reversed) tour_2opt_move(t, c, s2, s1, d);
+
+}
+
+// Find the reconnection of a sequential 3-opt move
+Reconnection tour_3opt_reconnection(const tour *t, const int *x, int *abc) {
+
+    // First node of each removed edge, in the orientation of the array
+    int first[3];
+
+    for (int e = 0; e < 3; e++) {
+
+        int u = x[2 * e];
+        int v = x[2 * e + 1];
+
+        if (tour_next(t, u) == v) first[e] = u;
+        else if (tour_next(t, v) == u) first[e] = v;
+        else return RECONNECT_INVALID;
+
+    }
+
+    if (first[0] == first[1] || first[0] == first[2] || first[1] == first[2]) return RECONNECT_INVALID;
+
+    // Order the edges along the tour, starting from the first one
+    int b_edge = tour_between(t, first[0], first[1], first[2]) ? 1 : 2;
+
+    int a = first[0];
+    int b = first[b_edge];
+    int c = first[3 - b_edge];
+
+    int a2 = tour_next(t, a);
+    int b2 = tour_next(t, b);
+    int c2 = tour_next(t, c);
+
+    abc[0] = a;
+    abc[1] = b;
+    abc[2] = c;
+
+    // Compare the added edges with the ones of each reconnection
+    const int pattern[4][6] = {
+
+        {a, b, a2, c, b2, c2},      // RECONNECT_REVERSE_BOTH
+        {a, b2, c, a2, b, c2},      // RECONNECT_EXCHANGE
+        {a, b2, c, b, a2, c2},      // RECONNECT_EXCHANGE_REVERSE_1
+        {a, c, b2, a2, b, c2}       // RECONNECT_EXCHANGE_REVERSE_2
+
+    };
+
+    for (int r = 0; r < 4; r++) {
+
+        bool found = true;
+
+        for (int e = 0; e < 3 && found; e++) {
+
+            int u = x[2 * e + 1];
+            int v = x[(2 * e + 2) % 6];
+
+            found = same_edge(u, v, pattern[r][0], pattern[r][1]) ||
+                    same_edge(u, v, pattern[r][2], pattern[r][3]) ||
+                    same_edge(u, v, pattern[r][4], pattern[r][5]);
+
+        }
+
+        if (found) return (Reconnection) (RECONNECT_REVERSE_BOTH + r);
+
+    }
+
+    return RECONNECT_INVALID;
+
+}
+
+// Apply a 3-opt move that changes all the three edges
+void tour_3opt_move(tour *t, const int a, const int b, const int c, const Reconnection type) {
+
+    int a2 = tour_next(t, a);
+    int b2 = tour_next(t, b);
+    int c2 = tour_next(t, c);
+
+    switch (type) {
+
+        case RECONNECT_REVERSE_BOTH:
+
+            // a -> b ... a' -> b' ... c -> c', then a -> b ... a' -> c ... b' -> c'
+            tour_2opt_move(t, a, a2, b, b2);
+            tour_2opt_move(t, a2, b2, c, c2);
+            break;
+
+        case RECONNECT_EXCHANGE:                tour_or_move(t, a2, b, c, c2, false);   break;
+        case RECONNECT_EXCHANGE_REVERSE_1:      tour_or_move(t, a2, b, c, c2, true);    break;
+        case RECONNECT_EXCHANGE_REVERSE_2:      tour_or_move(t, b2, c, a, a2, true);    break;
+        default:                                                                        break;
+
+    }
+
+}
+
+// Apply a double bridge
+void tour_double_bridge(tour *t, const int a, const int b, const int c, const int d) {
+
+    int a2 = tour_next(t, a);
+    int b2 = tour_next(t, b);
+    int c2 = tour_next(t, c);
+    int d2 = tour_next(t, d);
+
+    // a -> a' ... b -> b' ... c -> c' ... d -> d' becomes a -> d ... c' -> c ... b' -> b ... a' -> d'
+    tour_2opt_move(t, a, a2, d, d2);
+
+    // then each segment back to its orientation: a -> c' ... d -> b' ... c -> a' ... b -> d'
+    if (c2 != d) tour_2opt_move(t, a, d, c2, c);
+    if (b2 != c) tour_2opt_move(t, d, c, b2, b);
+    if (a2 != b) tour_2opt_move(t, c, b, a2, d2);
+
+}
+
+// Initialize a work queue with all the nodes
+void queue_init(work_queue *q, const int *nodes, const int n) {
+
+    q->n = n;
+    q->nodes = (int *) malloc(q->n * sizeof(int));
+    q->queued = (bool *) malloc(q->n * sizeof(bool));
+    if (q->nodes == NULL || q->queued == NULL) print_error("queue_init(): Cannot allocate memory");
+
+    for (int p = 0; p < q->n; p++) {
+
+        q->nodes[p] = nodes[p];
+        q->queued[nodes[p]] = true;
+
+    }
+
+    q->head = 0;
+    q->count = q->n;
+
+}
+
+// Free the memory of a work queue
+void queue_free(work_queue *q) {
+
+    free(q->nodes);
+    free(q->queued);
+    q->nodes = NULL;
+    q->queued = NULL;
+
+}
+
+// Append a node to a work queue
+void queue_push(work_queue *q, const int node) {
+
+    if (q->queued[node]) return;
+
+    int tail = q->head + q->count;
+    if (tail >= q->n) tail -= q->n;
+
+    q->nodes[tail] = node;
+    q->queued[node] = true;
+    q->count++;
+
+}
+
+// Remove the first node of a work queue
+int queue_pop(work_queue *q) {
+
+    int node = q->nodes[q->head];
+
+    if (++q->head == q->n) q->head = 0;
+    q->count--;
+    q->queued[node] = false;
+
+    return node;
+
+}
@@ -149,7 +149,7 @@ int xpos(const int i, const int j, const instance *inst) {
 
     if (i > j) return xpos(j,i,inst);
 
-    return i * inst->nnodes + j - ((i + 1) * (i + 2)) / 2;
+    return (int) edge_index(i, j, inst->nnodes);
 
 }
 
@@ -158,26 +158,41 @@ void build_model_CPLEX(instance *inst, CPXENVptr env, CPXLPptr lp) {
 
     // Set values for model constraints
     int izero = 0;
-    char binary = 'B'; 
     
-    char **cname = (char **) calloc(1, sizeof(char*));
-    if (cname == NULL) print_error("build_model_CPLEX(): Cannot allocate memory");
-    cname[0] = (char *) calloc(CONS_NAME_LEN, sizeof(char));
-    if (cname[0] == NULL) print_error("build_model_CPLEX(): Cannot allocate memory");
+    char **cname = (char **) calloc(inst->nnodes, sizeof(char*));
+    double *lb = (double *) malloc(inst->nnodes * sizeof(double));
+    double *ub = (double *) malloc(inst->nnodes * sizeof(double));
+    char *binary = (char *) malloc(inst->nnodes * sizeof(char));
+    double *obj = (double *) malloc(inst->nnodes * sizeof(double));
+    if (cname == NULL || lb == NULL || ub == NULL || binary == NULL || obj == NULL) print_error("build_model_CPLEX(): Cannot allocate memory");
+
+    for (int k=0; k<inst->nnodes; k++) {
+
+        cname[k] = (char *) calloc(CONS_NAME_LEN, sizeof(char));
+        if (cname[k] == NULL) print_error("build_model_CPLEX(): Cannot allocate memory");
+
+        lb[k] = 0.0; // lower bound
+        ub[k] = 1.0; // upper bound
+        binary[k] = 'B';
+
+    }
 
     // Add binary variable x(i,j) for each i < j and create the objective function  
-    for (int i=0; i<inst->nnodes; i++) {
+    // NOTE: The packed costs of the triangular layout follow xpos(), so the objective coefficients of a row are a contiguous slice
+    for (int i=0; i<inst->nnodes-1; i++) {
+
+        int first = xpos(i, i+1, inst);
+        int ncols = inst->nnodes - i - 1;
 
         for (int j=i+1; j<inst->nnodes; j++) {
 
-            sprintf_s(cname[0], CONS_NAME_LEN, "x(%5d,%5d)", i+1,j+1);
-            double obj = cost(i,j,inst); // objective coefficient   
-            double lb = 0.0; // lower bound
-            double ub = 1.0; // upper bound
-            if (CPXnewcols(env, lp, 1, &obj, &lb, &ub, &binary, cname)) print_error("CPXnewcols(): Cannot add variable");
-            if (CPXgetnumcols(env,lp)-1 != xpos(i,j, inst)) print_error("build_model_CPLEX(): Wrong number of columns in the model");
-        
+            sprintf_s(cname[j-i-1], CONS_NAME_LEN, "x(%5d,%5d)", i+1,j+1);
+            obj[j-i-1] = (inst->costs != NULL && inst->cost_layout == LAYOUT_TRIANGULAR) ? (double) inst->costs[first + j-i-1] : cost(i, j, inst); // objective coefficient
+
         }
+
+        if (CPXnewcols(env, lp, ncols, obj, lb, ub, binary, cname)) print_error("CPXnewcols(): Cannot add variable");
+        if (CPXgetnumcols(env,lp)-1 != xpos(i,inst->nnodes-1, inst)) print_error("build_model_CPLEX(): Wrong number of columns in the model");
     
     } 
 
@@ -214,8 +229,17 @@ void build_model_CPLEX(instance *inst, CPXENVptr env, CPXLPptr lp) {
     // If asked store the model in a file
     if (inst->verbose >= GOOD) CPXwriteprob(env, lp, "model.lp", NULL);   
 
-    free(cname[0]);
+    for (int k=0; k<inst->nnodes; k++) {
+
+        free(cname[k]);
+
+    }
+
     free(cname);
+    free(obj);
+    free(binary);
+    free(ub);
+    free(lb);
 
     inst->ncols = CPXgetnumcols(env, lp);
 
@@ -325,7 +349,7 @@ void build_solution_from_CPLEX(const instance *inst, solution *sol, const int *s
     }
 
     // Compute the cost of the solution
-    sol->cost = compute_solution_cost(inst, sol);
+    recompute_solution_cost(inst, sol);
 
     if (inst->verbose >= GOOD) {
 
@@ -51,6 +51,32 @@ void parse_command_line(const int argc, const char *argv[], instance *inst) {
             { inst->param2 = atoi(argv[++i]); continue; }  
         if (strcmp(argv[i], "-param3") == 0)                                                                    // third parameter for the method
             { inst->param3 = atoi(argv[++i]); continue; }
+        if (strcmp(argv[i], "-costmem") == 0)                                                                   // memory budget for the costs
+            { inst->cost_memory = atof(argv[++i]); continue; }
+        if (strcmp(argv[i], "-threads") == 0)                                                                   // number of threads
+            { inst->nthreads = atoi(argv[++i]); if (inst->nthreads < 0) { need_help = 1; break; } continue; }
+        if (strcmp(argv[i], "-cand") == 0)                                                                      // length of the candidate lists
+            { inst->cand_k = atoi(argv[++i]); if (inst->cand_k < 0) { need_help = 1; break; } continue; }
+        if (strcmp(argv[i], "-hilbert") == 0)                                                                   // renumber the nodes
+            { inst->hilbert = atoi(argv[++i]); continue; }
+        if (strcmp(argv[i], "-cache") == 0)                                                                     // use the binary cache
+            { inst->cache = atoi(argv[++i]); continue; }
+        if (strcmp(argv[i], "-ls") == 0)                                                                        // local search
+            { if (!parse_local_search_chain(argv[++i], &inst->local_search)) { need_help = 1; break; } continue; }
+        if (strcmp(argv[i], "-oropt") == 0)                                                                     // chain Or-opt
+            { inst->or_opt = atoi(argv[++i]); continue; }
+        if (strcmp(argv[i], "-lkdepth") == 0)                                                                   // depth of the LK moves
+            { inst->lk_depth = atoi(argv[++i]); if (inst->lk_depth < 1) { need_help = 1; break; } continue; }
+        if (strcmp(argv[i], "-dpwin") == 0)                                                                     // window of the DP re-optimization
+            { inst->dp_window = atoi(argv[++i]); if (inst->dp_window < 0 || inst->dp_window > DP_MAX_WINDOW) { need_help = 1; break; } continue; }
+        if (strcmp(argv[i], "-twolevel") == 0)                                                                  // two-level list tour
+            { inst->two_level_min = atoi(argv[++i]); continue; }
+        if (strcmp(argv[i], "-layout") == 0)                                                                    // layout of the cost matrix
+            { if (!parse_cost_layout(argv[++i], &inst->cost_layout)) { need_help = 1; break; } continue; }
+        if (strcmp(argv[i], "-gen") == 0)                                                                       // family of the random instance
+            { if (!parse_generator_family(argv[++i], &inst->generator)) { need_help = 1; break; } continue; }
+        if (strcmp(argv[i], "-out") == 0)                                                                       // output file
+            { strncpy_s(inst->output_file, FILE_NAME_LEN, argv[++i], _TRUNCATE); continue; }
         if (strcmp(argv[i], "--help") == 0)                                                                     // help
             { help = 1; continue; } 
 
@@ -78,11 +104,25 @@ void parse_command_line(const int argc, const char *argv[], instance *inst) {
         printf("-timelimit <time>         The time limit in seconds, must be positive\n");
         printf("-verbose <level>          The verbosity level of the debugging printing\n");
         printf("-method <method>          The method used to solve the problem\n");
-        printf("                          Available methods: %s, %s, %s, %s, %s, %s, %s, %s, %s", NEAREST_NEIGHBOR, 
-            MULTI_START_NN, EXTRA_MILEAGE, VNS, TABU_SEARCH, BENDERS, BRANCH_AND_CUT, HARD_FIXING, LOCAL_BRANCHING);
+        printf("                          Available methods: %s, %s, %s, %s, %s, %s, %s, %s, %s, %s, %s\n", NEAREST_NEIGHBOR, 
+            MULTI_START_NN, EXTRA_MILEAGE, VNS, TABU_SEARCH, LIN_KERNIGHAN, HELD_KARP, BENDERS, BRANCH_AND_CUT, HARD_FIXING, LOCAL_BRANCHING);
         printf("-param1 <param>           The first parameter for the method\n");
         printf("-param2 <param>           The second parameter for the method\n");
         printf("-param3 <param>           The third parameter for the method\n");
+        printf("-ls <local search>        The local search used to refine the solutions: 2opt (default), 2opt_nl, oropt, 3opt, lk or 2opt_par (candidate lists), dp\n");
+        printf("                          A comma-separated chain (e.g. 2opt_nl,oropt,dp) is applied by Variable Neighborhood Descent, at most %d\n", LS_MAX_CHAIN);
+        printf("-oropt <0|1>              Chain Or-opt after the local search, 0 (default) for no\n");
+        printf("-lkdepth <steps>          The maximum number of steps of a Lin-Kernighan move (default 50)\n");
+        printf("-dpwin <nodes>            Chain the exact DP re-optimization of windows of this many nodes (4 to %d) after the local search, 0 (default) for no\n", DP_MAX_WINDOW);
+        printf("-twolevel <nodes>         Use the two-level list tour in the local searches from this many nodes (default 50000), 0 for never\n");
+        printf("-costmem <MB>             The memory budget for the cost matrix, above it costs are computed on the fly\n");
+        printf("-threads <n>              The number of threads, 0 (default) for one for each processor\n");
+        printf("-cand <K>                 The length of the candidate lists of nearest nodes, 0 (default) for no lists\n");
+        printf("-hilbert <0|1>            Renumber the nodes along a Hilbert curve for cache locality, 0 (default) for no\n");
+        printf("-cache <0|1>              Load the input file from its binary cache (.tspbin), written if missing, 0 (default) for no\n");
+        printf("-layout <layout>          The layout of the cost matrix: triangular (default), full or tiled\n");
+        printf("-gen <family>             The family of the random instance: rand (default), uniform, cluster or grid\n");
+        printf("-out <file's path>        Write the built instance, as a TSPLIB file or as a .tspbin file\n");
 
         exit(0);
 
@@ -127,19 +167,21 @@ double get_time_in_milliseconds() {
 
 }
 
-// Draw a random value between 0 and 1.
-double random01(void) {
+// Get the number of threads to use.
+int get_number_of_threads(const instance *inst) {
 
-    return ((double) rand() / RAND_MAX);
+    if (inst->nthreads > 0) return inst->nthreads;
 
-}
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
 
-// Compute the Euclidean distance between two points.
-double dist(const coordinate point1, const coordinate point2) {
+    return (info.dwNumberOfProcessors > 0) ? (int) info.dwNumberOfProcessors : 1;
 
-    double deltax = point1.x-point2.x;
-    double deltay = point1.y-point2.y;
+}
 
-    return sqrt(deltax * deltax + deltay * deltay);
+// Draw a random value between 0 and 1.
+double random01(void) {
+
+    return ((double) rand() / RAND_MAX);
 
 }
@@ -5,12 +5,36 @@ void initialize_instance(instance *inst) {
 
     inst->nnodes = DEFAULT_NNODES;
     inst->coord = NULL;
+    inst->x = NULL;
+    inst->y = NULL;
+    inst->edge_weight_type = EUCLIDEAN;
+    inst->distance = distance_kernel(EUCLIDEAN);
     inst->costs = NULL;
+    inst->cost_layout = DEFAULT_COST_LAYOUT;
+    inst->ntiles = 0;
+    inst->tile_index = NULL;
+    inst->cost_memory = DEFAULT_COST_MEMORY;
+    inst->nthreads = DEFAULT_THREADS;
+    inst->cand_k = DEFAULT_CANDIDATES;
+    inst->cand = NULL;
+    inst->cand_cost = NULL;
+    inst->hilbert = DEFAULT_HILBERT;
+    inst->original_id = NULL;
+    inst->cache = DEFAULT_CACHE;
+    inst->cache_view = NULL;
+    inst->generator = GEN_RAND;
+    inst->local_search.len = 1;
+    inst->local_search.ops[0] = DEFAULT_LOCAL_SEARCH;
+    inst->or_opt = DEFAULT_OR_OPT;
+    inst->two_level_min = DEFAULT_TWO_LEVEL_MIN;
+    inst->lk_depth = DEFAULT_LK_DEPTH;
+    inst->dp_window = DEFAULT_DP_WINDOW;
     inst->best_solution = NULL;
 
     inst->name[0] = EMPTY_STRING;
     inst->seed = DEFAULT_SEED;
     inst->input_file[0] = EMPTY_STRING;
+    inst->output_file[0] = EMPTY_STRING;
     inst->asked_method[0] = EMPTY_STRING;
     inst->param1 = DEFAULT_PARAMETER;
     inst->param2 = DEFAULT_PARAMETER;
@@ -28,6 +52,28 @@ void build_instance(instance *inst) {
 
     name_instance(inst);
 
+    // The neighbor-list local searches need candidate lists, even if they were not asked
+    if (local_search_needs_candidates(inst) && inst->cand_k == 0) {
+
+        inst->cand_k = DEFAULT_LS_CANDIDATES;
+
+        if (inst->verbose >= LOW) {
+
+            ls_chain chain;
+            char chain_name[LS_CHAIN_NAME_LEN];
+            build_local_search_chain(inst, &chain);
+            local_search_chain_name(&chain, chain_name, LS_CHAIN_NAME_LEN);
+            printf("Local search %s: using candidate lists of %d nodes\n", chain_name, inst->cand_k);
+
+        }
+
+    }
+
+    unsigned long long source_hash = 0;
+    bool use_cache = false;
+    bool loaded = false;
+    char cache_name[FILE_NAME_LEN];
+
     if (inst->input_file[0] != EMPTY_STRING) {
 
         // Using input file
@@ -37,7 +83,21 @@ void build_instance(instance *inst) {
 
         }
 
-        basic_TSPLIB_parser(inst);
+        if (is_cache_file(inst->input_file)) {
+
+            // A cache file given as input is the instance already built
+            loaded = load_instance_cache(inst, inst->input_file, 0, false);
+            if (!loaded) print_error("build_instance(): Cannot load the cache file");
+
+        } else {
+
+            // If asked, load the instance already built from the cache of the file
+            use_cache = inst->cache && cache_file_name(inst, cache_name) && hash_file(inst->input_file, &source_hash);
+            loaded = use_cache && load_instance_cache(inst, cache_name, source_hash, true);
+
+            if (!loaded) TSPLIB_parser(inst);
+
+        }
 
     } else {
 
@@ -48,12 +108,35 @@ void build_instance(instance *inst) {
 
         }
 
-        random_instance_generator(inst);
+        if (inst->generator == GEN_RAND) random_instance_generator(inst);
+        else generate_instance(inst);
 
     }
 
-    // Compute all edges' cost
-    compute_all_costs(inst);
+    // Select the distance kernel once: the costs computed on the fly call it without any dispatch
+    inst->distance = distance_kernel(inst->edge_weight_type);
+
+    if (!loaded) {
+
+        // If asked, renumber the nodes so that near nodes have near ids
+        if (inst->hilbert) renumber_nodes_hilbert(inst);
+
+        // Copy the coordinates in the layout used by the distance kernels
+        build_coordinate_arrays(inst);
+
+        // Compute all edges' cost
+        compute_all_costs(inst);
+
+        // If asked, build the candidate lists
+        build_candidate_lists(inst);
+
+        // Write the cache for the next runs on the same file
+        if (use_cache) save_instance_cache(inst, cache_name, source_hash);
+
+    }
+
+    // If asked, write the built instance
+    if (inst->output_file[0] != EMPTY_STRING) write_instance(inst);
 
 }
 
@@ -94,49 +177,408 @@ void random_instance_generator(instance *inst) {
 
 }
 
-// Parse a TSPLIB format file to extract only node coordinates
-void basic_TSPLIB_parser(instance *inst) {
-    
-    FILE *file;
-    if (fopen_s(&file, inst->input_file, "r")) print_error("basic_TSPLIB_parser(): Cannot open file");
-    
-    char line[256]; // To store a line of the file
+// Write the built instance in the output file
+void write_instance(const instance *inst) {
+
+    if (is_cache_file(inst->output_file)) {
+
+        // No source file: the cache is read back only when given as input file
+        if (!save_instance_cache(inst, inst->output_file, 0)) print_error("write_instance(): Cannot write the output file");
+
+    } else {
+
+        write_tsplib_file(inst, inst->output_file);
+
+    }
+
+}
+
+// Write the coordinates of the instance as a TSPLIB file
+void write_tsplib_file(const instance *inst, const char *filename) {
+
+    double t_start = get_time_in_milliseconds();
+
+    if (inst->coord == NULL || inst->edge_weight_type == EXPLICIT) print_error("write_tsplib_file(): Explicit weights can only be written in a .tspbin file");
+    if (inst->edge_weight_type == EUCLIDEAN) print_error("write_tsplib_file(): Real valued costs have no TSPLIB type: use -gen or a .tspbin file");
+
+    FILE *f = NULL;
+    if (fopen_s(&f, filename, "w") || f == NULL) print_error("write_tsplib_file(): Cannot open file");
+
+    // Large buffer: millions of lines are written
+    setvbuf(f, NULL, _IOFBF, TSPLIB_WRITE_BUFFER);
+
+    fprintf(f, "NAME : %s\n", inst->name);
+    fprintf(f, "TYPE : TSP\n");
+    fprintf(f, "DIMENSION : %d\n", inst->nnodes);
+    fprintf(f, "EDGE_WEIGHT_TYPE : %s\n", edge_weight_type_name(inst->edge_weight_type));
+    fprintf(f, "NODE_COORD_SECTION\n");
+
+    // Nodes in their original order, if they were renumbered
+    int *node = NULL;
+
+    if (inst->original_id != NULL) {
+
+        node = (int *) malloc(inst->nnodes * sizeof(int));
+        if (node == NULL) print_error("write_tsplib_file(): Cannot allocate memory");
+
+        for (int i = 0; i < inst->nnodes; i++) node[inst->original_id[i]] = i;
+
+    }
+
+    for (int k = 0; k < inst->nnodes; k++) {
+
+        int i = (node != NULL) ? node[k] : k;
+        fprintf(f, "%d %.15g %.15g\n", k + 1, inst->coord[i].x, inst->coord[i].y);
+
+    }
+
+    fprintf(f, "EOF\n");
+
+    free(node);
+
+    if (ferror(f) | fclose(f)) print_error("write_tsplib_file(): Cannot write file");
+
+    if (inst->verbose >= LOW) {
+
+        printf("Written %s in %lf seconds\n", filename, get_elapsed_time(t_start));
+
+    }
+
+}
+
+// Parse a TSPLIB format file through a read-only memory mapping
+void TSPLIB_parser(instance *inst) {
+
+    double t_start = get_time_in_milliseconds();
+
+    // Map the whole file in memory
+    HANDLE file = CreateFileA(inst->input_file, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) print_error("TSPLIB_parser(): Cannot open file");
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) print_error("TSPLIB_parser(): Empty or unreadable file");
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) print_error("TSPLIB_parser(): Cannot map file");
+
+    const char *data = (const char *) MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) print_error("TSPLIB_parser(): Cannot map file");
+
+    const char *p = data;
+    const char *end = data + file_size.QuadPart;
+
     inst->nnodes = 0; // Safety measure: avoid using uninitialized value 
     inst->coord = NULL; // Safety measure: avoid using uninitialized value
-    
-    while (fgets(line, sizeof(line), file)) {
 
-        // Find the dimension
-        if (strstr(line, "DIMENSION")) {
+    EdgeWeightFormat format = FUNCTION;
+    bool allocated = false;
+    bool has_weights = false;
 
-            sscanf_s(line, "DIMENSION : %d", &inst->nnodes);
-            
-            // Allocate memory after finding dimension
-            allocate_instance(inst);
+    while (p < end) {
 
-        }
-        
-        // Read all coordinates
-        if (strstr(line, "NODE_COORD_SECTION")) {
+        // Read the keyword at the beginning of the line
+        skip_blanks(&p, end);
+        if (p < end && (*p == '\n' || *p == '\r')) { p++; continue; }
+
+        const char *keyword = p;
+        while (p < end && (isalnum((unsigned char) *p) || *p == '_')) p++;
+        size_t keyword_len = p - keyword;
+
+        // Move to the value, if any
+        skip_blanks(&p, end);
+        if (p < end && *p == ':') p++;
+        skip_blanks(&p, end);
+
+        // Read the value as a token
+        const char *value = p;
+        while (p < end && (isalnum((unsigned char) *p) || *p == '_')) p++;
+        size_t value_len = p - value;
+        p = value;
+
+        if (keyword_matches(keyword, keyword_len, "DIMENSION")) {
+
+            long dimension;
+            if (!scan_int(&p, end, &dimension) || dimension < 1) print_error("TSPLIB_parser(): Wrong DIMENSION");
+            inst->nnodes = (int) dimension;
+
+        } else if (keyword_matches(keyword, keyword_len, "EDGE_WEIGHT_TYPE")) {
+
+            if (keyword_matches(value, value_len, "EUC_2D")) inst->edge_weight_type = EUC_2D;
+            else if (keyword_matches(value, value_len, "CEIL_2D")) inst->edge_weight_type = CEIL_2D;
+            else if (keyword_matches(value, value_len, "ATT")) inst->edge_weight_type = ATT;
+            else if (keyword_matches(value, value_len, "GEO")) inst->edge_weight_type = GEO;
+            else if (keyword_matches(value, value_len, "EXPLICIT")) inst->edge_weight_type = EXPLICIT;
+            else print_error("TSPLIB_parser(): Unsupported EDGE_WEIGHT_TYPE");
 
-            int index = 0;
+        } else if (keyword_matches(keyword, keyword_len, "EDGE_WEIGHT_FORMAT")) {
 
-            while (index < inst->nnodes && fgets(line, sizeof(line), file)) {
+            if (keyword_matches(value, value_len, "FUNCTION")) format = FUNCTION;
+            else if (keyword_matches(value, value_len, "FULL_MATRIX")) format = FULL_MATRIX;
+            else if (keyword_matches(value, value_len, "UPPER_ROW") || keyword_matches(value, value_len, "LOWER_COL")) format = UPPER_ROW;
+            else if (keyword_matches(value, value_len, "LOWER_ROW") || keyword_matches(value, value_len, "UPPER_COL")) format = LOWER_ROW;
+            else if (keyword_matches(value, value_len, "UPPER_DIAG_ROW") || keyword_matches(value, value_len, "LOWER_DIAG_COL")) format = UPPER_DIAG_ROW;
+            else if (keyword_matches(value, value_len, "LOWER_DIAG_ROW") || keyword_matches(value, value_len, "UPPER_DIAG_COL")) format = LOWER_DIAG_ROW;
+            else print_error("TSPLIB_parser(): Unsupported EDGE_WEIGHT_FORMAT");
 
-                if (strstr(line, "EOF")) break;
-                
-                int temp_id;
-                sscanf_s(line, "%d %lf %lf", &temp_id, &inst->coord[index].x, &inst->coord[index].y);
-                index++;
+        } else if (keyword_matches(keyword, keyword_len, "NODE_COORD_SECTION") || 
+                   keyword_matches(keyword, keyword_len, "DISPLAY_DATA_SECTION")) {
+
+            if (inst->nnodes < 1) print_error("TSPLIB_parser(): Section found before DIMENSION");
+
+            // Allocate memory once the header is known
+            if (!allocated) { allocate_instance(inst); allocated = true; }
+
+            // Explicit instances may have coordinates only for displaying
+            if (inst->coord == NULL) {
+
+                inst->coord = (coordinate *) calloc(inst->nnodes, sizeof(coordinate));
+                if (inst->coord == NULL) print_error("TSPLIB_parser(): Cannot allocate memory");
 
             }
 
-            break; // Exit the main loop once we've read all coordinates
+            // Read all coordinates: "id x y" for each node
+            for (int index = 0; index < inst->nnodes; index++) {
+
+                long temp_id;
+
+                if (!scan_int(&p, end, &temp_id) || 
+                    !scan_double(&p, end, &inst->coord[index].x) || 
+                    !scan_double(&p, end, &inst->coord[index].y)) {
+
+                    print_error("TSPLIB_parser(): Wrong or missing node coordinates");
+
+                }
+
+            }
+
+        } else if (keyword_matches(keyword, keyword_len, "EDGE_WEIGHT_SECTION")) {
+
+            if (inst->nnodes < 1) print_error("TSPLIB_parser(): Section found before DIMENSION");
+            if (inst->edge_weight_type != EXPLICIT || format == FUNCTION) print_error("TSPLIB_parser(): EDGE_WEIGHT_SECTION without EXPLICIT weights");
+
+            // Allocate memory once the header is known
+            if (!allocated) { allocate_instance(inst); allocated = true; }
+
+            parse_edge_weight_section(inst, format, &p, end);
+            has_weights = true;
+
+        } else if (keyword_matches(keyword, keyword_len, "EOF")) {
+
+            break;
 
         }
+
+        // Ignore the rest of the line (NAME, COMMENT, TYPE, ...)
+        skip_line(&p, end);
+
+    }
+
+    if (!allocated) print_error("TSPLIB_parser(): No data section found");
+    if (inst->edge_weight_type == EXPLICIT && !has_weights) print_error("TSPLIB_parser(): EDGE_WEIGHT_SECTION not found");
+    if (inst->edge_weight_type != EXPLICIT && inst->coord == NULL) print_error("TSPLIB_parser(): NODE_COORD_SECTION not found");
+
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    CloseHandle(file);
+
+    if (inst->verbose >= LOW) {
+
+        double elapsed = get_elapsed_time(t_start);
+        double megabytes = (double) file_size.QuadPart / (1024.0 * 1024.0);
+
+        printf("Parsed %s: %.3lf MB in %.6lf s (%.2lf MB/s)\n", inst->input_file, megabytes, elapsed, 
+            (elapsed > 0) ? megabytes / elapsed : INFINITY);
+
+    }
+
+}
+
+// Read the explicit edge weights and store them directly in the costs
+void parse_edge_weight_section(instance *inst, const EdgeWeightFormat format, const char **p, const char *end) {
+
+    int n = inst->nnodes;
+
+    for (int i = 0; i < n; i++) {
+
+        // Range of columns stored in the i-th row
+        int first, last;
+
+        switch (format) {
+
+            case UPPER_ROW:         first = i + 1;  last = n - 1;   break;
+            case LOWER_ROW:         first = 0;      last = i - 1;   break;
+            case UPPER_DIAG_ROW:    first = i;      last = n - 1;   break;
+            case LOWER_DIAG_ROW:    first = 0;      last = i;       break;
+            default:
+            case FULL_MATRIX:       first = 0;      last = n - 1;   break;
+
+        }
+
+        for (int j = first; j <= last; j++) {
+
+            double weight;
+            if (!scan_double(p, end, &weight)) print_error("parse_edge_weight_section(): Wrong or missing edge weights");
+
+            // The diagonal is not a valid edge
+            if (i != j) set_cost(i, j, weight, inst);
+
+        }
+
     }
-    
-    fclose(file);
+
+}
+
+// Skip spaces and tabs, but not the end of line
+void skip_blanks(const char **p, const char *end) {
+
+    while (*p < end && (**p == ' ' || **p == '\t')) (*p)++;
+
+}
+
+// Skip everything up to and including the end of line
+void skip_line(const char **p, const char *end) {
+
+    while (*p < end && **p != '\n') (*p)++;
+    if (*p < end) (*p)++;
+
+}
+
+// Check if the keyword read from the file is exactly the expected one
+bool keyword_matches(const char *keyword, const size_t len, const char *expected) {
+
+    return strlen(expected) == len && strncmp(keyword, expected, len) == 0;
+
+}
+
+// Read a (signed) integer, skipping any leading white space
+bool scan_int(const char **p, const char *end, long *value) {
+
+    const char *s = *p;
+    while (s < end && isspace((unsigned char) *s)) s++;
+
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) { negative = (*s == '-'); s++; }
+
+    if (s >= end || !isdigit((unsigned char) *s)) return false;
+
+    long result = 0;
+    while (s < end && isdigit((unsigned char) *s)) {
+
+        // The next digit would overflow the long
+        int digit = *s - '0';
+        if (result > (LONG_MAX - digit) / 10) return false;
+
+        result = result * 10 + digit;
+        s++;
+
+    }
+
+    *value = negative ? -result : result;
+    *p = s;
+
+    return true;
+
+}
+
+// Read a floating point number (also in scientific notation), skipping any leading white space
+bool scan_double(const char **p, const char *end, double *value) {
+
+    // Exact powers of ten: every value up to 1e22 is exactly representable as a double
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *s = *p;
+    while (s < end && isspace((unsigned char) *s)) s++;
+
+    const char *start = s;
+
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) { negative = (*s == '-'); s++; }
+
+    unsigned long long mantissa = 0;
+    int ndigits = 0;    // Significant digits stored in the mantissa
+    int exponent = 0;   // Decimal exponent to apply to the mantissa
+    bool any_digit = false;
+
+    // Integer part
+    while (s < end && isdigit((unsigned char) *s)) {
+
+        if (ndigits < 19) { mantissa = mantissa * 10 + (*s - '0'); if (mantissa > 0) ndigits++; }
+        else exponent++;
+        any_digit = true;
+        s++;
+
+    }
+
+    // Fractional part
+    if (s < end && *s == '.') {
+
+        s++;
+
+        while (s < end && isdigit((unsigned char) *s)) {
+
+            if (ndigits < 19) { mantissa = mantissa * 10 + (*s - '0'); if (mantissa > 0) ndigits++; exponent--; }
+            any_digit = true;
+            s++;
+
+        }
+
+    }
+
+    if (!any_digit) return false;
+
+    // Exponent part
+    if (s + 1 < end && (*s == 'e' || *s == 'E') && (isdigit((unsigned char) s[1]) || s[1] == '+' || s[1] == '-')) {
+
+        const char *e = s + 1;
+        const char *digits = (*e == '+' || *e == '-') ? e + 1 : e;
+        long exp_value;
+
+        if (scan_int(&e, end, &exp_value)) {
+
+            // The exponent is added to the one of the digits only if the sum cannot overflow
+            if (exp_value > SCAN_MAX_EXPONENT || exp_value < -SCAN_MAX_EXPONENT) return false;
+
+            exponent += (int) exp_value;
+            s = e;
+
+        } else if (digits < end && isdigit((unsigned char) *digits)) {
+
+            // The digits of the exponent overflow a long
+            return false;
+
+        }
+
+    }
+
+    if (mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+
+        // Fast path: both the mantissa and the power of ten are exact, so the result is correctly rounded
+        double result = (double) mantissa;
+        result = (exponent < 0) ? result / pow10[-exponent] : result * pow10[exponent];
+        *value = negative ? -result : result;
+
+    } else {
+
+        // Slow path: let the C library handle the rounding, on a copy of the number (the text is not terminated)
+        char local[64];
+        size_t len = s - start;
+        char *buffer = (len < sizeof(local)) ? local : (char *) malloc(len + 1);
+        if (buffer == NULL) print_error("scan_double(): Cannot allocate memory");
+
+        memcpy(buffer, start, len);
+        buffer[len] = EMPTY_STRING;
+        *value = strtod(buffer, NULL);
+
+        if (buffer != local) free(buffer);
+
+    }
+
+    *p = s;
+
+    return true;
 
 }
 
@@ -178,7 +620,8 @@ void name_instance(instance *inst) {
 
     } else { // Random instance
 
-        sprintf_s(inst->name, INST_NAME_LEN, "random_n%d_s%d", inst->nnodes, inst->seed);
+        if (inst->generator == GEN_RAND) sprintf_s(inst->name, INST_NAME_LEN, "random_n%d_s%d", inst->nnodes, inst->seed);
+        else sprintf_s(inst->name, INST_NAME_LEN, "%s_n%d_s%d", generator_family_name(inst->generator), inst->nnodes, inst->seed);
 
     }
 
@@ -187,30 +630,501 @@ void name_instance(instance *inst) {
 // Compute the distance between every node to every node in the instance
 void compute_all_costs(instance *inst) {
 
+    // Matrix-free mode: costs are computed when needed
+    // Explicit instances: costs already read from the file
+    if (inst->costs == NULL || inst->edge_weight_type == EXPLICIT) return;
+
+    double t_start = get_time_in_milliseconds();
+
+    // Do not use more threads than blocks of rows
+    int nblocks = (inst->nnodes + COST_ROWS_BLOCK - 1) / COST_ROWS_BLOCK;
+    int nthreads = get_number_of_threads(inst);
+    if (nthreads > nblocks) nthreads = nblocks;
+    if (nthreads < 1) nthreads = 1;
+
+    cost_worker_data *data = (cost_worker_data *) malloc(nthreads * sizeof(cost_worker_data));
+    HANDLE *threads = (HANDLE *) malloc(nthreads * sizeof(HANDLE));
+
+    if (data == NULL || threads == NULL) print_error("compute_all_costs(): Cannot allocate memory");
+
+    for (int t = 0; t < nthreads; t++) {
+
+        data[t].inst = inst;
+        data[t].thread_id = t;
+        data[t].nthreads = nthreads;
+
+    }
+
+    if (nthreads == 1) {
+
+        compute_costs_worker(&data[0]);
+
+    } else {
+
+        for (int t = 0; t < nthreads; t++) {
+
+            threads[t] = CreateThread(NULL, 0, compute_costs_worker, &data[t], 0, NULL);
+            if (threads[t] == NULL) print_error("compute_all_costs(): Cannot create thread");
+
+        }
+
+        WaitForMultipleObjects(nthreads, threads, TRUE, INFINITE);
+
+        for (int t = 0; t < nthreads; t++) CloseHandle(threads[t]);
+
+    }
+
+    free(threads);
+    free(data);
+
+    if (inst->verbose >= LOW) {
+
+        printf("Costs computed in %lf seconds (%s kernel, %s layout, %d threads)\n", get_elapsed_time(t_start), SIMD_NAME, cost_layout_name(inst->cost_layout), nthreads);
+
+    }
+
+}
+
+// Compute the rows of the cost matrix assigned to a thread
+DWORD WINAPI compute_costs_worker(LPVOID param) {
+
+    cost_worker_data *data = (cost_worker_data *) param;
+    instance *inst = data->inst;
+    int n = inst->nnodes;
+
+    // Rows of the packed upper triangle are stored one after the other:
+    // row i holds the costs from node i to the nodes i+1, ..., n-1, which are contiguous in the coordinate arrays
+    // Rows get shorter and shorter, so blocks of rows are dealt to the threads in turn to balance the work
+    // NOTE: COST_ROWS_BLOCK is a multiple of COST_TILE, so a row of tiles is filled by a single thread
+    int rows = (inst->cost_layout == LAYOUT_TRIANGULAR) ? n - 1 : n;
+
+    for (int first = data->thread_id * COST_ROWS_BLOCK; first < rows; first += data->nthreads * COST_ROWS_BLOCK) {
+
+        int last = (first + COST_ROWS_BLOCK < rows) ? first + COST_ROWS_BLOCK : rows;
+
+        for (int i = first; i < last; i++) {
+
+            switch (inst->cost_layout) {
+
+                case LAYOUT_FULL: {
+
+                    // The whole row, diagonal included (never read)
+                    distance_row(inst, inst->x[i], inst->y[i], inst->x, inst->y, n, &inst->costs[(size_t) i * n]);
+                    break;
+
+                }
+
+                case LAYOUT_TILED: {
+
+                    // Row i of each tile from the diagonal one: the diagonal tile is filled whole, its lower half is never read
+                    int r = i >> COST_TILE_BITS;
+                    size_t offset = (size_t) (i & (COST_TILE - 1)) << COST_TILE_BITS;
+
+                    for (int c = r; c < inst->ntiles; c++) {
+
+                        int col = c << COST_TILE_BITS;
+                        int count = (n - col < COST_TILE) ? n - col : COST_TILE;
+                        size_t tile = (size_t) inst->tile_index[r * inst->ntiles + c];
+
+                        distance_row(inst, inst->x[i], inst->y[i], &inst->x[col], &inst->y[col], count, &inst->costs[(tile << (2 * COST_TILE_BITS)) + offset]);
+
+                    }
+
+                    break;
+
+                }
+
+                default: {
+
+                    cost_t *row = &inst->costs[edge_index(i, i + 1, n)];
+                    distance_row(inst, inst->x[i], inst->y[i], &inst->x[i + 1], &inst->y[i + 1], n - i - 1, row);
+                    break;
+
+                }
+
+            }
+
+        }
+
+    }
+
+    return 0;
+
+}
+
+// Build the position of each tile of the tiled cost matrix
+void build_tile_index(instance *inst) {
+
+    if (inst->cost_layout != LAYOUT_TILED) return;
+
+    inst->ntiles = (inst->nnodes + COST_TILE - 1) / COST_TILE;
+
+    if (inst->tile_index == NULL) {
+
+        inst->tile_index = (int *) malloc((size_t) inst->ntiles * inst->ntiles * sizeof(int));
+        if (inst->tile_index == NULL) print_error("build_tile_index(): Cannot allocate memory");
+
+    }
+
+    // Smallest power of 2 grid that contains all the tiles
+    int side = 1;
+    while (side < inst->ntiles) side <<= 1;
+
+    // Walk the Z-order curve of the grid: the bits of the code alternate the ones of the column and of the row
+    int next = 0;
+
+    for (long long z = 0; z < (long long) side * side; z++) {
+
+        int r = 0;
+        int c = 0;
+
+        for (int b = 0; (1 << b) < side; b++) {
+
+            c |= (int) ((z >> (2 * b)) & 1) << b;
+            r |= (int) ((z >> (2 * b + 1)) & 1) << b;
+
+        }
+
+        // Tiles of the upper triangle only, the lower ones hold the same edges
+        if (r <= c && c < inst->ntiles) inst->tile_index[r * inst->ntiles + c] = next++;
+
+    }
+
+}
+
+// Build the lists of the K nearest nodes of each node
+void build_candidate_lists(instance *inst) {
+
+    if (inst->cand_k <= 0) return;
+
+    double t_start = get_time_in_milliseconds();
+
+    if (inst->cand_k > inst->nnodes - 1) inst->cand_k = inst->nnodes - 1;
+    int k = inst->cand_k;
+
+    inst->cand = (int *) malloc((size_t) inst->nnodes * k * sizeof(int));
+    inst->cand_cost = (cost_t *) malloc((size_t) inst->nnodes * k * sizeof(cost_t));
+
+    if (inst->cand == NULL || inst->cand_cost == NULL) print_error("build_candidate_lists(): Cannot allocate memory");
+
+    // The kd-tree finds the nearest nodes in Euclidean distance, so it is used only for the types that are
+    // non-decreasing functions of it
+    bool use_tree = kd_tree_supports(inst);
+
+    if (use_tree) {
+
+        kd_tree tree;
+        build_kd_tree(&tree, inst->x, inst->y, inst->nnodes);
+
+        // Working memory for the queries, large enough for all the nodes
+        int *buffer = (int *) malloc(inst->nnodes * sizeof(int));
+        cost_t *buffer_cost = (cost_t *) malloc(inst->nnodes * sizeof(cost_t));
+        double *dist2 = (double *) malloc(inst->nnodes * sizeof(double));
+
+        if (buffer == NULL || buffer_cost == NULL || dist2 == NULL) print_error("build_candidate_lists(): Cannot allocate memory");
+
+        for (int i = 0; i < inst->nnodes; i++) {
+
+            int *list = &inst->cand[(size_t) i * k];
+            cost_t *list_cost = &inst->cand_cost[(size_t) i * k];
+
+            // Costs are rounded, so nodes farther than the k-th may have its same cost and a lower index:
+            // ask for more nodes until the last one costs more than the k-th, then keep the first k by (cost, index)
+            int m = k;
+
+            while (true) {
+
+                m = kd_tree_k_nearest(&tree, i, m, buffer, dist2);
+
+                for (int r = 0; r < m; r++) buffer_cost[r] = (cost_t) cost(i, buffer[r], inst);
+
+                if (m == inst->nnodes - 1 || buffer_cost[m - 1] > buffer_cost[k - 1]) break;
+
+                m = (2 * m < inst->nnodes - 1) ? 2 * m : inst->nnodes - 1;
+
+            }
+
+            sort_candidate_list(buffer, buffer_cost, m);
+
+            memcpy(list, buffer, k * sizeof(int));
+            memcpy(list_cost, buffer_cost, k * sizeof(cost_t));
+
+        }
+
+        free(buffer);
+        free(buffer_cost);
+        free(dist2);
+        free_kd_tree(&tree);
+
+    } else {
+
+        // Keep the K best nodes of the row of each node
+        for (int i = 0; i < inst->nnodes; i++) {
+
+            int *list = &inst->cand[(size_t) i * k];
+            cost_t *list_cost = &inst->cand_cost[(size_t) i * k];
+            int found = 0;
+
+            for (int j = 0; j < inst->nnodes; j++) {
+
+                if (j == i) continue;
+
+                cost_t c = (cost_t) cost(i, j, inst);
+
+                // Nodes are scanned by increasing index, so ties keep the lower index first
+                if (found == k && c >= list_cost[k - 1]) continue;
+
+                int pos = (found < k) ? found++ : k - 1;
+
+                while (pos > 0 && list_cost[pos - 1] > c) {
+
+                    list[pos] = list[pos - 1];
+                    list_cost[pos] = list_cost[pos - 1];
+                    pos--;
+
+                }
+
+                list[pos] = j;
+                list_cost[pos] = c;
+
+            }
+
+        }
+
+    }
+
+    if (inst->verbose >= LOW) {
+
+        printf("Candidate lists of %d nodes built in %lf seconds (%s)\n", k, get_elapsed_time(t_start), use_tree ? "kd-tree" : "full rows");
+
+    }
+
+}
+
+// Sort a candidate list by increasing cost, ties by increasing index
+void sort_candidate_list(int *list, cost_t *list_cost, const int k) {
+
+    for (int r = 1; r < k; r++) {
+
+        int node = list[r];
+        cost_t c = list_cost[r];
+        int pos = r;
+
+        while (pos > 0 && (list_cost[pos - 1] > c || (list_cost[pos - 1] == c && list[pos - 1] > node))) {
+
+            list[pos] = list[pos - 1];
+            list_cost[pos] = list_cost[pos - 1];
+            pos--;
+
+        }
+
+        list[pos] = node;
+        list_cost[pos] = c;
+
+    }
+
+}
+
+// Renumber the nodes in the order of a Hilbert curve over their coordinates
+void renumber_nodes_hilbert(instance *inst) {
+
+    // Explicit costs are already stored with the original ids
+    if (inst->coord == NULL || inst->edge_weight_type == EXPLICIT) {
+
+        if (inst->verbose >= LOW) {
+
+            printf("Hilbert renumbering skipped: the instance has explicit costs\n");
+
+        }
+
+        return;
+
+    }
+
+    double t_start = get_time_in_milliseconds();
+
+    // Bounding box of the nodes, mapped on a grid of 2^HILBERT_ORDER cells for each side
+    double xmin = INFINITY, xmax = -INFINITY, ymin = INFINITY, ymax = -INFINITY;
+
+    for (int i = 0; i < inst->nnodes; i++) {
+
+        if (inst->coord[i].x < xmin) xmin = inst->coord[i].x;
+        if (inst->coord[i].x > xmax) xmax = inst->coord[i].x;
+        if (inst->coord[i].y < ymin) ymin = inst->coord[i].y;
+        if (inst->coord[i].y > ymax) ymax = inst->coord[i].y;
+
+    }
+
+    double side = (xmax - xmin > ymax - ymin) ? xmax - xmin : ymax - ymin;
+    double scale = (side > 0.0) ? ((1u << HILBERT_ORDER) - 1) / side : 0.0;
+
+    hilbert_node *order = (hilbert_node *) malloc(inst->nnodes * sizeof(hilbert_node));
+    coordinate *coord = (coordinate *) malloc(inst->nnodes * sizeof(coordinate));
+    inst->original_id = (int *) malloc(inst->nnodes * sizeof(int));
+
+    if (order == NULL || coord == NULL || inst->original_id == NULL) print_error("renumber_nodes_hilbert(): Cannot allocate memory");
+
+    for (int i = 0; i < inst->nnodes; i++) {
+
+        unsigned int cx = (unsigned int) ((inst->coord[i].x - xmin) * scale);
+        unsigned int cy = (unsigned int) ((inst->coord[i].y - ymin) * scale);
+
+        order[i].key = hilbert_key(cx, cy);
+        order[i].id = i;
+
+    }
+
+    qsort(order, inst->nnodes, sizeof(hilbert_node), compare_hilbert_nodes);
+
+    // The node in position i of the curve becomes node i
     for (int i = 0; i < inst->nnodes; i++) {
 
-        for (int j = 0; j < inst->nnodes; j++) {
+        inst->original_id[i] = order[i].id;
+        coord[i] = inst->coord[order[i].id];
+
+    }
+
+    memcpy(inst->coord, coord, inst->nnodes * sizeof(coordinate));
+
+    free(coord);
+    free(order);
+
+    if (inst->verbose >= LOW) {
+
+        printf("Nodes renumbered along a Hilbert curve in %lf seconds\n", get_elapsed_time(t_start));
+
+    }
+
+}
+
+// Compute the position of a cell along the Hilbert curve
+unsigned long long hilbert_key(unsigned int x, unsigned int y) {
 
-            if (i == j) { // Self-to-self distance set to INF
+    unsigned long long key = 0;
 
-                inst->costs[i * inst->nnodes + j] = INFINITY;
+    for (unsigned int s = 1u << (HILBERT_ORDER - 1); s > 0; s >>= 1) {
 
-            } else {
+        unsigned int rx = (x & s) ? 1 : 0;
+        unsigned int ry = (y & s) ? 1 : 0;
 
-                inst->costs[i * inst->nnodes + j] = dist(inst->coord[i], inst->coord[j]);
+        key += (unsigned long long) s * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant, so that the curve inside it starts and ends at the right corners
+        if (ry == 0) {
+
+            if (rx == 1) {
+
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
 
             }
 
+            unsigned int temp = x;
+            x = y;
+            y = temp;
+
         }
 
     }
 
+    return key;
+
 }
 
-// Return the distance between two nodes w.r.t. the given instance
-double cost(const int i, const int j, const instance *inst) {
+// Compare two nodes by their position along the Hilbert curve, then by id
+int compare_hilbert_nodes(const void *a, const void *b) {
+
+    const hilbert_node *first = (const hilbert_node *) a;
+    const hilbert_node *second = (const hilbert_node *) b;
 
-    return inst->costs[i * inst->nnodes + j];
+    if (first->key != second->key) return (first->key < second->key) ? -1 : 1;
+
+    return first->id - second->id;
+
+}
+
+// Map a solution and the instance back to the original ids of the nodes
+void restore_node_numbering(instance *inst, solution *sol) {
+
+    if (inst->original_id == NULL) return;
+
+    // Costs and candidate lists loaded from the cache are not owned by the instance
+    close_instance_cache(inst);
+
+    for (int i = 0; i <= inst->nnodes; i++) {
+
+        sol->visited_nodes[i] = inst->original_id[sol->visited_nodes[i]];
+
+    }
+
+    // Coordinates back in the original order
+    coordinate *coord = (coordinate *) malloc(inst->nnodes * sizeof(coordinate));
+    if (coord == NULL) print_error("restore_node_numbering(): Cannot allocate memory");
+
+    for (int i = 0; i < inst->nnodes; i++) coord[inst->original_id[i]] = inst->coord[i];
+
+    memcpy(inst->coord, coord, inst->nnodes * sizeof(coordinate));
+    free(coord);
+
+    // Costs and candidate lists are indexed by the renumbered ids: drop them and compute the costs on the fly
+    if (inst->costs != NULL) {
+
+        free(inst->costs);
+        inst->costs = NULL;
+
+    }
+
+    if (inst->cand != NULL) {
+
+        free(inst->cand);
+        free(inst->cand_cost);
+        inst->cand = NULL;
+        inst->cand_cost = NULL;
+        inst->cand_k = 0;
+
+    }
+
+    _aligned_free(inst->x);
+    _aligned_free(inst->y);
+    inst->x = NULL;
+    inst->y = NULL;
+    build_coordinate_arrays(inst);
+
+    free(inst->original_id);
+    inst->original_id = NULL;
+
+}
+
+// Copy the coordinates of the nodes in aligned and padded arrays
+void build_coordinate_arrays(instance *inst) {
+
+    if (inst->coord == NULL) return;
+
+    // Pad to a multiple of the SIMD width, so that a full vector load never goes out of bounds
+    size_t padded = ((size_t) inst->nnodes + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+
+    inst->x = (double *) _aligned_malloc(padded * sizeof(double), SIMD_ALIGNMENT);
+    inst->y = (double *) _aligned_malloc(padded * sizeof(double), SIMD_ALIGNMENT);
+
+    if (inst->x == NULL || inst->y == NULL) print_error("build_coordinate_arrays(): Cannot allocate memory");
+
+    for (size_t i = 0; i < padded; i++) {
+
+        inst->x[i] = (i < (size_t) inst->nnodes) ? inst->coord[i].x : 0.0;
+        inst->y[i] = (i < (size_t) inst->nnodes) ? inst->coord[i].y : 0.0;
+
+    }
+
+}
+
+// Set the distance between two nodes w.r.t. the given instance
+void set_cost(const int i, const int j, const double value, instance *inst) {
+
+    if (i == j) return;
+
+    // The same position for the symmetric layouts
+    inst->costs[cost_index(i, j, inst)] = to_cost(value);
+    inst->costs[cost_index(j, i, inst)] = to_cost(value);
 
 }
 
@@ -219,8 +1133,17 @@ void print_instance(const instance *inst) {
     printf("Name: %s\n", inst->name);
     printf("Seed: %5d\n", inst->seed);
     printf("Input file %s\n", inst->input_file);
+    if (inst->input_file[0] == EMPTY_STRING) printf("Generator: %s\n", generator_family_name(inst->generator));
     printf("Nnodes: %5d\n", inst->nnodes);
+    printf("Edge weight type: %s\n", edge_weight_type_name(inst->edge_weight_type));
+    printf("Cost type: %s (%d bytes)\n", COST_TYPE_NAME, (int) sizeof(cost_t));
+    printf("Cost layout: %s\n", cost_layout_name(inst->cost_layout));
     printf("Asked method: %s\n", inst->asked_method);
+    ls_chain chain;
+    char chain_name[LS_CHAIN_NAME_LEN];
+    build_local_search_chain(inst, &chain);
+    local_search_chain_name(&chain, chain_name, LS_CHAIN_NAME_LEN);
+    printf("Local search: %s\n", chain_name);
 
     printf("\n");
 
@@ -251,7 +1174,7 @@ void print_instance(const instance *inst) {
 
             for(int j=i+1; j<inst->nnodes; j++) {
 
-                printf("Edge[%5d, %5d]: %10.6lf\t\t", i, j, inst->costs[i*inst->nnodes + j]);
+                printf("Edge[%5d, %5d]: %10.6lf\t\t", i, j, cost(i, j, inst));
 
             }
 
@@ -263,20 +1186,110 @@ void print_instance(const instance *inst) {
 
 }
 
+// Return the TSPLIB name of the edge weight type
+const char *edge_weight_type_name(const EdgeWeightType type) {
+
+    switch (type) {
+
+        case EUC_2D:    return "EUC_2D";
+        case CEIL_2D:   return "CEIL_2D";
+        case ATT:       return "ATT";
+        case GEO:       return "GEO";
+        case EXPLICIT:  return "EXPLICIT";
+        default:
+        case EUCLIDEAN: return "EUCLIDEAN";
+
+    }
+
+}
+
+// Return the name of a cost matrix layout
+const char *cost_layout_name(const CostLayout layout) {
+
+    switch (layout) {
+
+        case LAYOUT_FULL:   return "full";
+        case LAYOUT_TILED:  return "tiled";
+        default:
+        case LAYOUT_TRIANGULAR: return "triangular";
+
+    }
+
+}
+
+// Read the name of a cost matrix layout
+bool parse_cost_layout(const char *name, CostLayout *layout) {
+
+    const CostLayout layouts[] = {LAYOUT_TRIANGULAR, LAYOUT_FULL, LAYOUT_TILED};
+
+    for (int l = 0; l < (int) (sizeof(layouts) / sizeof(layouts[0])); l++) {
+
+        if (strcmp(name, cost_layout_name(layouts[l])) == 0) {
+
+            *layout = layouts[l];
+            return true;
+
+        }
+
+    }
+
+    return false;
+
+}
+
 // Allocate the memory for the most space-consuming attributes of instance
 void allocate_instance(instance *inst) {
 
-    // Allocate memory for nodes' coordinate
-    inst->coord = (coordinate*) calloc(inst->nnodes, sizeof(coordinate));
+    // Allocate memory for nodes' coordinate, if the costs come from them
+    if (inst->edge_weight_type != EXPLICIT) {
+
+        inst->coord = (coordinate*) calloc(inst->nnodes, sizeof(coordinate));
+        if (inst->coord == NULL) print_error("allocate_instance(): Cannot allocate memory");
+
+    }
+
+    // Allocate memory for edges' cost: only the upper triangle, without diagonal
+    // If it does not fit the memory budget, use the matrix-free mode (not possible for explicit weights)
+    double megabytes = (double) cost_matrix_size(inst->nnodes, inst->cost_layout) * sizeof(cost_t) / (1024.0 * 1024.0);
+    bool matrix_free = (megabytes > inst->cost_memory && inst->edge_weight_type != EXPLICIT);
+
+    inst->costs = NULL;
+
+    if (!matrix_free) {
+
+        inst->costs = (cost_t *) calloc(cost_matrix_size(inst->nnodes, inst->cost_layout) + 1, sizeof(cost_t));
+        
+        if (inst->costs == NULL) {
+
+            if (inst->edge_weight_type == EXPLICIT) print_error("allocate_instance(): Cannot allocate memory");
+            matrix_free = true;
+
+        }
+
+    }
+
+    // Position of the tiles, if the matrix is tiled
+    if (inst->costs != NULL) build_tile_index(inst);
+
+    if (inst->verbose >= LOW) {
+
+        if (matrix_free) {
+
+            printf("Cost matrix of %.1lf MB does not fit the budget of %.1lf MB: costs computed on the fly\n", megabytes, inst->cost_memory);
 
-    // Allocate memory for edges' cost
-    inst->costs = (double *) calloc(inst->nnodes * inst->nnodes, sizeof(double));
+        } else if (megabytes > inst->cost_memory) {
+
+            printf("Cost matrix of %.1lf MB exceeds the budget of %.1lf MB, but explicit weights must be stored\n", megabytes, inst->cost_memory);
+
+        }
+
+    }
 
     // Allocate memory for the best solution
     inst->best_solution = (solution *) malloc(sizeof(solution));
 
     // Check if memory allocation was successful
-    if (inst->coord == NULL || inst->costs == NULL || inst->best_solution == NULL) {
+    if (inst->best_solution == NULL) {
 
         print_error("allocate_instance(): Cannot allocate memory");
 
@@ -291,6 +1304,9 @@ void allocate_instance(instance *inst) {
 // Free the most space-consuming attributes of instance from memory
 void free_instance(instance *inst) {
 
+    // Costs and candidate lists loaded from the cache are not owned by the instance
+    close_instance_cache(inst);
+
     // Deallocate memory for nodes' coordinate
     if (inst->coord != NULL) {
 
@@ -299,6 +1315,52 @@ void free_instance(instance *inst) {
 
     }
 
+    // Deallocate memory for the coordinate arrays
+    if (inst->x != NULL) {
+
+        _aligned_free(inst->x);
+        inst->x = NULL;
+
+    }
+
+    if (inst->y != NULL) {
+
+        _aligned_free(inst->y);
+        inst->y = NULL;
+
+    }
+
+    // Deallocate memory for the original ids
+    if (inst->original_id != NULL) {
+
+        free(inst->original_id);
+        inst->original_id = NULL;
+
+    }
+
+    // Deallocate memory for the candidate lists
+    if (inst->cand != NULL) {
+
+        free(inst->cand);
+        inst->cand = NULL;
+
+    }
+
+    if (inst->cand_cost != NULL) {
+
+        free(inst->cand_cost);
+        inst->cand_cost = NULL;
+
+    }
+
+    // Deallocate memory for the position of the tiles
+    if (inst->tile_index != NULL) {
+
+        free(inst->tile_index);
+        inst->tile_index = NULL;
+
+    }
+
     // Deallocate memory for edges' cost
     if (inst->costs != NULL) {
 
@@ -5,6 +5,7 @@ void initialize_solution(solution *sol) {
 
     sol->cost = INFINITY;
     sol->visited_nodes = NULL;
+    sol->edge_cost = NULL;
     sol->method[0] = EMPTY_STRING;
 
 }
@@ -31,7 +32,17 @@ void solve_with_method(instance *inst, solution *sol) {
 
     double timelimit = inst->timelimit - get_elapsed_time(inst->t_start);
 
-    if (strcmp(inst->asked_method, NEAREST_NEIGHBOR) == 0) {
+    // Small instances are solved exactly by DP: the CPLEX methods would pay the start of CPLEX for nothing
+    bool cplex_method = (strcmp(inst->asked_method, BENDERS) == 0 || strcmp(inst->asked_method, BRANCH_AND_CUT) == 0 ||
+                         strcmp(inst->asked_method, HARD_FIXING) == 0 || strcmp(inst->asked_method, LOCAL_BRANCHING) == 0);
+
+    if (cplex_method && inst->nnodes <= DP_EXACT_MAX_NODES) {
+
+        printf("Solving with Held-Karp dynamic programming (%d nodes, no CPLEX needed).\n", inst->nnodes);
+
+        held_karp_tour(inst, sol);
+
+    } else if (strcmp(inst->asked_method, NEAREST_NEIGHBOR) == 0) {
 
         printf("Solving with Nearest Neighbor method.\n");
 
@@ -40,7 +51,7 @@ void solve_with_method(instance *inst, solution *sol) {
         // Refinement if asked
         if (inst->param1 == 1) {
 
-            two_opt(inst, sol, timelimit - get_elapsed_time(inst->t_start), true);
+            local_search(inst, sol, timelimit - get_elapsed_time(inst->t_start), true);
 
         }
 
@@ -59,7 +70,7 @@ void solve_with_method(instance *inst, solution *sol) {
         // Refinement if asked
         if (inst->param1 == 1) {
 
-            two_opt(inst, sol, timelimit - get_elapsed_time(inst->t_start), true);
+            local_search(inst, sol, timelimit - get_elapsed_time(inst->t_start), true);
 
         }
 
@@ -81,6 +92,23 @@ void solve_with_method(instance *inst, solution *sol) {
         double elapsed_time = get_elapsed_time(inst->t_start);
         tabu_search(inst, sol, (timelimit-elapsed_time));
         
+    } else if (strcmp(inst->asked_method, LIN_KERNIGHAN) == 0) {
+
+        printf("Solving with Lin-Kernighan method.\n");
+
+        nearest_neighbor(inst, sol, rand() % inst->nnodes);
+
+        double elapsed_time = get_elapsed_time(inst->t_start);
+        chained_lin_kernighan(inst, sol, (timelimit-elapsed_time));
+
+    } else if (strcmp(inst->asked_method, HELD_KARP) == 0) {
+
+        printf("Solving with Held-Karp dynamic programming.\n");
+
+        if (inst->nnodes > DP_EXACT_MAX_NODES) print_error("solve_with_method(): DP solves instances of at most 20 nodes");
+
+        held_karp_tour(inst, sol);
+
     } else if (strcmp(inst->asked_method, BENDERS) == 0) {
 
         printf("Solving with Benders' loop method.\n");
@@ -96,7 +124,7 @@ void solve_with_method(instance *inst, solution *sol) {
             nearest_neighbor(inst, sol, rand() % inst->nnodes);
             double timelimit1 = timelimit * 0.1;
             timelimit1 = (timelimit1 > 1) ? 1 : timelimit1; // Ensure at most 1 second for warm-up
-            two_opt(inst, sol, timelimit1, false);
+            local_search(inst, sol, timelimit1, false);
 
         }
 
@@ -121,7 +149,7 @@ void solve_with_method(instance *inst, solution *sol) {
         double timelimit1 = timelimit * 0.1;
         tabu_search(inst, sol, timelimit1);
         // Ensure two-opt solution as warm-up
-        two_opt(inst, sol, timelimit1, false);
+        local_search(inst, sol, timelimit1, false);
 
         // Restore parameters
         inst->param1 = param1;
@@ -149,7 +177,7 @@ void solve_with_method(instance *inst, solution *sol) {
         double timelimit1 = timelimit * 0.1;
         tabu_search(inst, sol, timelimit1);
         // Ensure two-opt solution as warm-up
-        two_opt(inst, sol, timelimit1, false);
+        local_search(inst, sol, timelimit1, false);
 
         // Restore parameters
         inst->param1 = param1;
@@ -221,6 +249,15 @@ double compute_solution_cost(const instance *inst, const solution *sol) {
 
     double computed_cost = 0;
 
+    // Cached edge costs: a sequential sum
+    if (sol->edge_cost != NULL) {
+
+        for (int i = 0; i < inst->nnodes; i++) computed_cost += sol->edge_cost[i];
+
+        return computed_cost;
+
+    }
+
     for (int i = 0; i < inst->nnodes; i++) {
 
         // Remember an edge of the tour is stored in two consecutive elements
@@ -232,6 +269,55 @@ double compute_solution_cost(const instance *inst, const solution *sol) {
 
 }
 
+// Cache the costs of the edges of the solution
+void cache_edge_costs(const instance *inst, solution *sol) {
+
+    if (sol->edge_cost == NULL) {
+
+        sol->edge_cost = (double *) malloc(inst->nnodes * sizeof(double));
+        if (sol->edge_cost == NULL) print_error("cache_edge_costs(): Cannot allocate memory");
+
+    }
+
+    for (int i = 0; i < inst->nnodes; i++) {
+
+        sol->edge_cost[i] = cost(sol->visited_nodes[i], sol->visited_nodes[i + 1], inst);
+
+    }
+
+}
+
+// Recompute the cost of the solution after its tour was rewritten
+void recompute_solution_cost(const instance *inst, solution *sol) {
+
+    if (sol->edge_cost != NULL) cache_edge_costs(inst, sol);
+
+    sol->cost = compute_solution_cost(inst, sol);
+
+}
+
+// Check if the cached edge costs are the ones of the tour
+bool validate_edge_costs(const instance *inst, const solution *sol) {
+
+    if (sol->edge_cost == NULL) return true;
+
+    for (int i = 0; i < inst->nnodes; i++) {
+
+        double expected = cost(sol->visited_nodes[i], sol->visited_nodes[i + 1], inst);
+
+        if (sol->edge_cost[i] != expected) {
+
+            fprintf(stderr, "Edge cost mismatch at position %d! Expected: %10.6lf, Cached: %10.6lf\n", i, expected, sol->edge_cost[i]);
+            return false;
+
+        }
+
+    }
+
+    return true;
+
+}
+
 // Check if the cost in the solution is the expected one
 bool validate_cost(const instance *inst, const solution *sol) {
 
@@ -258,6 +344,12 @@ void check_sol(const instance *inst, const solution *sol) {
 
     }
 
+    if (!validate_edge_costs(inst, sol)) {
+
+        print_error("check_sol(): The cached edge costs are not valid");
+
+    }
+
     if (!validate_cost(inst, sol)) {
 
         print_error("check_sol(): The solution cost is not valid");
@@ -288,6 +380,16 @@ bool update_sol(const instance *inst, solution *sol1, const solution *sol2, bool
         sol1->cost = sol2->cost;
         strncpy_s(sol1->method, METH_NAME_LEN, sol2->method, _TRUNCATE);
         memcpy(sol1->visited_nodes, sol2->visited_nodes, (inst->nnodes + 1) * sizeof(int));
+
+        if (sol1->edge_cost != NULL && sol2->edge_cost != NULL) {
+
+            memcpy(sol1->edge_cost, sol2->edge_cost, inst->nnodes * sizeof(double));
+
+        } else if (sol1->edge_cost != NULL) {
+
+            cache_edge_costs(inst, sol1);
+
+        }
         
         return true;
     }
@@ -305,11 +407,33 @@ void copy_sol(solution *sol1, const solution *sol2, const int nnodes) {
     strncpy_s(sol1->method, METH_NAME_LEN, sol2->method, _TRUNCATE);
     memcpy(sol1->visited_nodes, sol2->visited_nodes, (nnodes + 1) * sizeof(int));
 
+    if (sol2->edge_cost != NULL) {
+
+        sol1->edge_cost = (double *) malloc(nnodes * sizeof(double));
+        if (sol1->edge_cost == NULL) print_error("copy_sol(): Cannot allocate memory");
+
+        memcpy(sol1->edge_cost, sol2->edge_cost, nnodes * sizeof(double));
+
+    }
+
 }
 
 // Plot the solution using gnuplot
 void plot_solution(const instance *inst, const solution *sol) {
 
+    // Nothing to draw without coordinates
+    if (inst->coord == NULL) {
+
+        if (inst->verbose >= GOOD) {
+
+            printf("No coordinates available: plot skipped\n");
+
+        }
+
+        return;
+
+    }
+
     // Use gnuplot to print the solution
     FILE *gnuplot = open_plot();
 
@@ -390,4 +514,11 @@ void free_solution(solution *sol) {
         
     }
 
+    if (sol->edge_cost != NULL) {
+
+        free(sol->edge_cost);
+        sol->edge_cost = NULL;
+
+    }
+
 }
\ No newline at end of file
@@ -10,9 +10,15 @@ void vns(const instance *inst, solution *sol, const double timelimit) {
     solution temp_sol; 
     copy_sol(&temp_sol, sol, inst->nnodes);
 
-    int k, reps;
-    if (inst->param1 != 3 && inst->param1 != 5) { k = DEAULT_K; }
-    if (inst->param2 < 1) { reps = DEFAULT_REPS; }
+    // The kicks and the 2-opt moves read the removed edges from the cache
+    cache_edge_costs(inst, &temp_sol);
+
+    int k = (inst->param1 == 3 || inst->param1 == 5) ? inst->param1 : DEAULT_K;
+    int reps = (inst->param2 >= 1) ? inst->param2 : DEFAULT_REPS;
+
+    // Buffer for the kicks, allocated once
+    int *scratch = (int *) malloc(inst->nnodes * sizeof(int));
+    if (scratch == NULL) print_error("vns(): Cannot allocate memory");
 
     char method_name[METH_NAME_LEN];
     sprintf_s(method_name, METH_NAME_LEN, "%s_k%d_r%d", VNS, k, reps);
@@ -32,7 +38,7 @@ void vns(const instance *inst, solution *sol, const double timelimit) {
     while ((residual_time = timelimit - get_elapsed_time(t_start)) > 0) {
 
         // go to local optima
-        two_opt(inst, &temp_sol, residual_time, false);
+        local_search(inst, &temp_sol, residual_time, false);
 
         // update local best solution
         double old_cost = sol->cost;
@@ -53,7 +59,7 @@ void vns(const instance *inst, solution *sol, const double timelimit) {
         }
 
         // escape local minima
-        kick(inst, &temp_sol, k, reps);
+        kick(inst, &temp_sol, k, reps, scratch);
 
         if (inst->verbose >= ONLY_INCUMBENT && is_asked_method) {
 
@@ -65,6 +71,8 @@ void vns(const instance *inst, solution *sol, const double timelimit) {
 
     }
     
+    free(scratch);
+
     if (updated) {
 
         strncpy_s(sol->method, METH_NAME_LEN, method_name, _TRUNCATE);
@@ -87,125 +95,62 @@ void vns(const instance *inst, solution *sol, const double timelimit) {
 }
 
 // Algorithm to modify the solution to escape the current local optima
-void kick(const instance *inst, solution *sol, const int k, const int reps) {
-
-    switch (k) {
-
-        default: 
-        case 3:
-
-            for (int i = 0; i < reps; i++) {
-
-                int idx1, idx2, idx3;
-                select_three_indices(inst->nnodes, &idx1, &idx2, &idx3);
-
-                if (inst->verbose >= DEBUG_V) {
-
-                    printf("Kick with %5d, %5d, %5d\n", idx1, idx2, idx3);
-
-                }
-                
-                // Update the solution cost
-                sol->cost += delta3(inst, sol, idx1, idx2, idx3);
-                            
-                // Perform the move
-                shift_segment(sol, inst->nnodes, idx1, idx2, idx3);
-                
-                if (inst->verbose >= GOOD) {
-
-                    check_sol(inst, sol);
-
-                }
+void kick(const instance *inst, solution *sol, const int k, const int reps, int *scratch) {
 
-            }
+    kopt_move move;
 
-            break;
+    for (int i = 0; i < reps; i++) {
 
-        case 5:
+        switch (k) {
 
-            for (int i = 0; i < reps; i++) {
+            default: 
+            case 3:
 
-                int idx1, idx2, idx3, idx4, idx5;
-                select_five_indices(inst->nnodes, &idx1, &idx2, &idx3, &idx4, &idx5);
+                // A-B-C-D to A-C-B-D
+                select_three_indices(inst->nnodes, &move.idx[0], &move.idx[1], &move.idx[2]);
 
-                if (inst->verbose >= DEBUG_V) {
+                move.k = 3;
+                move.order[0] = 2;  move.reversed[0] = false;
+                move.order[1] = 1;  move.reversed[1] = false;
 
-                    printf("Kick with %5d, %5d, %5d, %5d, %5d\n", idx1, idx2, idx3,idx4, idx5);
+                break;
 
-                }
-        
-                // Update the solution cost
-                sol->cost += delta5(inst, sol, idx1, idx2, idx3, idx4, idx5);
-                
-                // Perform the move
-                fixed_five_opt_move(sol, inst->nnodes, idx1, idx2, idx3, idx4, idx5);
-                
-                if (inst->verbose >= GOOD) {
-
-                    check_sol(inst, sol);
-                
-                }
-            
-            }
+            case 5:
 
-            break;
+                // A-B-C-D-E-F to A-D-!B-E-!C-F
+                select_five_indices(inst->nnodes, &move.idx[0], &move.idx[1], &move.idx[2], &move.idx[3], &move.idx[4]);
 
-    }
+                move.k = 5;
+                move.order[0] = 3;  move.reversed[0] = false;
+                move.order[1] = 1;  move.reversed[1] = true;
+                move.order[2] = 4;  move.reversed[2] = false;
+                move.order[3] = 2;  move.reversed[3] = true;
 
-}
+                break;
 
-// Rearrange tour segments in the solution
-void fixed_five_opt_move(solution *sol, const int nnodes, int idx1, int idx2, int idx3, int idx4, int idx5) {
+        }
 
-    // Compute segmants's size
-    int segmentB_size = idx2 - idx1;
-    int segmentC_size = idx3 - idx2;
-    int segmentD_size = idx4 - idx3;
-    int segmentE_size = idx5 - idx4;
+        if (inst->verbose >= DEBUG_V) {
 
-    // A-B-D-C-E-F
-    shift_segment(sol, nnodes, idx2, idx3, idx4);
-    idx3 = idx2 + segmentD_size;
-    idx4 = idx3 + segmentC_size;
+            printf("Kick with");
+            for (int j = 0; j < move.k; j++) printf(" %5d", move.idx[j]);
+            printf("\n");
 
-    // A-D-B-C-E-F
-    shift_segment(sol, nnodes, idx1, idx2, idx3);
-    idx2 = idx1 + segmentD_size;
-    idx3 = idx2 + segmentB_size;
+        }
 
-    // A-D-B-E-C-F
-    shift_segment(sol, nnodes, idx3, idx4, idx5);
-    idx4 = idx3 + segmentE_size;
-    idx5 = idx4 + segmentC_size;
+        // Update the solution cost
+        sol->cost += kopt_delta(inst, sol, &move);
 
-    // A-D-!B-E-C-F
-    reverse_segment(sol, idx2+1, idx3);
+        // Perform the move
+        apply_kopt_move(inst, sol, &move, scratch);
 
-    // A-D-!B-E-!C-F
-    reverse_segment(sol, idx4+1, idx5);
+        if (inst->verbose >= GOOD) {
 
-}
+            check_sol(inst, sol);
 
-// Compute the delta cost after the 5-opt move
-double delta5(const instance *inst, const solution *sol, const int idx1, const int idx2, const int idx3, const int idx4, const int idx5) {
+        }
 
-    // compute the cost of the three edges that would be removed
-    // (idx1, idx1+1), (idx2, idx2+1), (idx3, idx3+1), (idx4, idx4+1), (idx4, idx4+1)
-    double old_cost = cost(sol->visited_nodes[idx1], sol->visited_nodes[idx1+1], inst) +
-                      cost(sol->visited_nodes[idx2], sol->visited_nodes[idx2+1], inst) +
-                      cost(sol->visited_nodes[idx3], sol->visited_nodes[idx3+1], inst) +
-                      cost(sol->visited_nodes[idx4], sol->visited_nodes[idx4+1], inst) +
-                      cost(sol->visited_nodes[idx5], sol->visited_nodes[idx5+1], inst);
-        
-    // compute the cost of the three new edges that would be added
-    // add edges (idx1, idx3+1), (idx4, idx2), (idx1+1, idx4+1), (idx5, idx3), (idx2+1, idx5+1)
-    double new_cost = cost(sol->visited_nodes[idx1], sol->visited_nodes[idx3+1], inst) +
-                      cost(sol->visited_nodes[idx4], sol->visited_nodes[idx2], inst) +
-                      cost(sol->visited_nodes[idx1+1], sol->visited_nodes[idx4+1], inst) +
-                      cost(sol->visited_nodes[idx5], sol->visited_nodes[idx3], inst) +
-                      cost(sol->visited_nodes[idx2+1], sol->visited_nodes[idx5+1], inst);
-        
-    return new_cost - old_cost;
+    }
 
 }
 